@@ -0,0 +1,701 @@
+/**
+ * sqlite3_gd_bench.cpp
+ *
+ * Native benchmark harness for SQLite3.gd.
+ *
+ * Runs parameterized scenarios against the same SQLite build as the extension,
+ * without Godot: insert throughput per batch size, point lookups, range scans,
+ * blob I/O, backup, serialize/deserialize, WAL reader/writer concurrency and
+ * the native vector functions. Results are written as JSON with ns/op, rows/s
+ * and SQLite heap allocations per operation, so releases and compile options
+ * can be compared on a headless machine.
+ *
+ *   sqlite3_gd_bench [--filter=substring] [--rows=N] [--duration-ms=N]
+ *                    [--tmpdir=path] [--out=file.json]
+ *
+ * With --replay, it instead re-executes a workload trace captured by
+ * SQLite3Database.start_capture() against a copy of --db (an empty in-memory
+ * database without it), after running the --setup SQL on the copy, and
+ * reports the replayed latencies per SQL next to the captured ones:
+ *
+ *   sqlite3_gd_bench --replay=trace.gdwl [--db=game.db] [--setup=SQL]
+ *                    [--speed=X] [--tmpdir=path] [--out=file.json]
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include "SQLite3Profiler.h"
+#include "SQLite3VectorFunctions.h"
+#include "SQLite3Workload.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// ---------------------------------------------------------------------------
+// Allocation counting, wrapped around SQLite's default allocator
+
+static sqlite3_mem_methods default_mem;
+static std::atomic<uint64_t> alloc_count(0);
+static std::atomic<uint64_t> alloc_bytes(0);
+
+static void* counting_malloc(int n) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    return default_mem.xMalloc(n);
+}
+
+static void* counting_realloc(void* p, int n) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    return default_mem.xRealloc(p, n);
+}
+
+static void install_counting_allocator() {
+    sqlite3_config(SQLITE_CONFIG_GETMALLOC, &default_mem);
+    sqlite3_mem_methods counting = default_mem;
+    counting.xMalloc = counting_malloc;
+    counting.xRealloc = counting_realloc;
+    sqlite3_config(SQLITE_CONFIG_MALLOC, &counting);
+}
+
+// ---------------------------------------------------------------------------
+// Results
+
+struct Options {
+    std::string filter;
+    std::string tmpdir = "/tmp";
+    std::string out;
+    int64_t rows = 100000;
+    int64_t duration_ms = 1000;
+    std::string replay;
+    std::string db;
+    std::string setup;
+    double speed = 0.0;
+};
+
+struct Result {
+    std::string scenario;
+    std::vector<std::pair<std::string, std::string>> params;
+    uint64_t ops = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    uint64_t total_ns = 0;
+    uint64_t allocs = 0;
+    uint64_t alloc_bytes = 0;
+    sqlite3_gd_prof::Histogram latency;  // Per operation, when measured
+    int rc = SQLITE_OK;
+};
+
+// Measures one run: operations are counted by the body, allocations and time here
+class Run {
+public:
+    Run(const std::string& scenario) {
+        _result.scenario = scenario;
+        _allocs = alloc_count.load();
+        _alloc_bytes = alloc_bytes.load();
+        _start = Clock::now();
+    }
+
+    Run& param(const std::string& name, int64_t value) {
+        _result.params.emplace_back(name, std::to_string(value));
+        return *this;
+    }
+
+    Run& param(const std::string& name, const std::string& value) {
+        _result.params.emplace_back(name, "\"" + value + "\"");
+        return *this;
+    }
+
+    Result& result() { return _result; }
+
+    Result finish(uint64_t ops, uint64_t rows, uint64_t bytes = 0) {
+        _result.total_ns = elapsed_ns(_start);
+        _result.ops = ops;
+        _result.rows = rows;
+        _result.bytes = bytes;
+        _result.allocs = alloc_count.load() - _allocs;
+        _result.alloc_bytes = alloc_bytes.load() - _alloc_bytes;
+        return _result;
+    }
+
+private:
+    Result _result;
+    uint64_t _allocs;
+    uint64_t _alloc_bytes;
+    Clock::time_point _start;
+};
+
+static void check(int rc, sqlite3* db, const char* what) {
+    if (rc != SQLITE_OK && rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        fprintf(stderr, "%s failed: %s\n", what, db ? sqlite3_errmsg(db) : sqlite3_errstr(rc));
+        exit(1);
+    }
+}
+
+static void exec(sqlite3* db, const char* sql) {
+    char* errmsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errmsg) != SQLITE_OK) {
+        fprintf(stderr, "SQL error: %s\n  in: %s\n", errmsg ? errmsg : "?", sql);
+        exit(1);
+    }
+}
+
+static sqlite3_stmt* prepare(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt = nullptr;
+    check(sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr), db, sql);
+    return stmt;
+}
+
+static sqlite3* open_db(const std::string& path) {
+    sqlite3* db = nullptr;
+    check(sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                          nullptr),
+          db, "open");
+    return db;
+}
+
+static std::string temp_path(const Options& options, const char* name) {
+    std::string path = options.tmpdir + "/sqlite3_gd_bench_" + name + ".db";
+    for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+        std::remove((path + suffix).c_str());
+    }
+    return path;
+}
+
+// Fills items(id INTEGER PRIMARY KEY, value INTEGER, name TEXT) with rows rows
+static void fill_items(sqlite3* db, int64_t rows) {
+    exec(db, "CREATE TABLE items (id INTEGER PRIMARY KEY, value INTEGER, name TEXT)");
+    exec(db, "BEGIN");
+    sqlite3_stmt* stmt = prepare(db, "INSERT INTO items (value, name) VALUES (?1, ?2)");
+    char name[32];
+    for (int64_t i = 0; i < rows; ++i) {
+        snprintf(name, sizeof(name), "item-%lld", (long long)i);
+        sqlite3_bind_int64(stmt, 1, i * 7 % 1000);
+        sqlite3_bind_text(stmt, 2, name, -1, SQLITE_TRANSIENT);
+        check(sqlite3_step(stmt), db, "fill");
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    exec(db, "COMMIT");
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+
+static void bench_insert(const Options& options, std::vector<Result>& results) {
+    for (int64_t batch : {1, 10, 100, 1000, 10000}) {
+        // Single-row transactions are slow by design, keep their run short
+        int64_t rows = std::min(options.rows, batch * 5000);
+        std::string path = temp_path(options, "insert");
+        sqlite3* db = open_db(path);
+        exec(db, "PRAGMA journal_mode = WAL");
+        exec(db, "PRAGMA synchronous = NORMAL");
+        exec(db, "CREATE TABLE items (id INTEGER PRIMARY KEY, value INTEGER, name TEXT)");
+        sqlite3_stmt* stmt = prepare(db, "INSERT INTO items (value, name) VALUES (?1, ?2)");
+
+        Run run("insert");
+        run.param("batch", batch).param("journal", "wal");
+        for (int64_t i = 0; i < rows; ++i) {
+            if (i % batch == 0) exec(db, "BEGIN");
+            sqlite3_bind_int64(stmt, 1, i);
+            sqlite3_bind_text(stmt, 2, "benchmark row", -1, SQLITE_STATIC);
+            check(sqlite3_step(stmt), db, "insert");
+            sqlite3_reset(stmt);
+            if (i % batch == batch - 1 || i == rows - 1) exec(db, "COMMIT");
+        }
+        results.push_back(run.finish(rows, rows));
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        std::remove(path.c_str());
+    }
+}
+
+static void bench_point_lookup(const Options& options, std::vector<Result>& results) {
+    sqlite3* db = open_db(":memory:");
+    fill_items(db, options.rows);
+    sqlite3_stmt* stmt = prepare(db, "SELECT value, name FROM items WHERE id = ?1");
+    std::mt19937_64 random(42);
+    int64_t lookups = std::max<int64_t>(options.rows, 100000);
+
+    Run run("point_lookup");
+    run.param("table_rows", options.rows);
+    uint64_t found = 0;
+    for (int64_t i = 0; i < lookups; ++i) {
+        Clock::time_point start = Clock::now();
+        sqlite3_bind_int64(stmt, 1, (int64_t)(random() % options.rows) + 1);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            found++;
+            sqlite3_column_int64(stmt, 0);
+            sqlite3_column_text(stmt, 1);
+        }
+        sqlite3_reset(stmt);
+        run.result().latency.record(elapsed_ns(start));
+    }
+    results.push_back(run.finish(lookups, found));
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+static void bench_range_scan(const Options& options, std::vector<Result>& results) {
+    sqlite3* db = open_db(":memory:");
+    fill_items(db, options.rows);
+    sqlite3_stmt* stmt = prepare(db, "SELECT id, value, name FROM items WHERE id BETWEEN ?1 AND ?2");
+    std::mt19937_64 random(7);
+
+    for (int64_t width : {100, 10000}) {
+        if (width > options.rows) continue;
+        int64_t scans = std::max<int64_t>(10, 1000000 / width);
+        Run run("range_scan");
+        run.param("width", width).param("table_rows", options.rows);
+        uint64_t rows = 0;
+        for (int64_t i = 0; i < scans; ++i) {
+            Clock::time_point start = Clock::now();
+            int64_t first = (int64_t)(random() % (options.rows - width + 1)) + 1;
+            sqlite3_bind_int64(stmt, 1, first);
+            sqlite3_bind_int64(stmt, 2, first + width - 1);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                sqlite3_column_int64(stmt, 1);
+                sqlite3_column_text(stmt, 2);
+                rows++;
+            }
+            sqlite3_reset(stmt);
+            run.result().latency.record(elapsed_ns(start));
+        }
+        results.push_back(run.finish(scans, rows));
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+static void bench_blob_io(const Options& options, std::vector<Result>& results) {
+    const int blob_size = 8 * 1024 * 1024;
+    std::string path = temp_path(options, "blob");
+    sqlite3* db = open_db(path);
+    exec(db, "PRAGMA journal_mode = WAL");
+    exec(db, "CREATE TABLE assets (id INTEGER PRIMARY KEY, data BLOB)");
+    exec(db, "INSERT INTO assets (id, data) VALUES (1, zeroblob(8388608))");
+    std::vector<uint8_t> buffer(1024 * 1024, 0x5a);
+
+    for (int chunk : {4096, 65536, 1048576}) {
+        for (bool write : {true, false}) {
+            sqlite3_blob* blob = nullptr;
+            if (write) exec(db, "BEGIN");
+            check(sqlite3_blob_open(db, "main", "assets", "data", 1, write ? 1 : 0, &blob), db, "blob_open");
+            Run run(write ? "blob_write" : "blob_read");
+            run.param("chunk", chunk).param("blob_bytes", blob_size);
+            uint64_t ops = 0;
+            for (int offset = 0; offset < blob_size; offset += chunk) {
+                int rc = write ? sqlite3_blob_write(blob, buffer.data(), chunk, offset)
+                               : sqlite3_blob_read(blob, buffer.data(), chunk, offset);
+                check(rc, db, "blob io");
+                ops++;
+            }
+            sqlite3_blob_close(blob);
+            if (write) exec(db, "COMMIT");
+            results.push_back(run.finish(ops, 0, blob_size));
+        }
+    }
+    sqlite3_close(db);
+    std::remove(path.c_str());
+}
+
+static void bench_backup(const Options& options, std::vector<Result>& results) {
+    sqlite3* source = open_db(":memory:");
+    fill_items(source, options.rows);
+    int pages = 0;
+
+    for (int step_pages : {-1, 64, 1024}) {
+        sqlite3* destination = open_db(":memory:");
+        sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+        Run run("backup");
+        run.param("pages_per_step", step_pages);
+        uint64_t steps = 0;
+        int rc = SQLITE_OK;
+        while (rc == SQLITE_OK) {
+            Clock::time_point start = Clock::now();
+            rc = sqlite3_backup_step(backup, step_pages);
+            run.result().latency.record(elapsed_ns(start));
+            steps++;
+        }
+        pages = sqlite3_backup_pagecount(backup);
+        run.result().rc = sqlite3_backup_finish(backup);
+        int page_size = 0;
+        sqlite3_stmt* stmt = prepare(source, "PRAGMA page_size");
+        if (sqlite3_step(stmt) == SQLITE_ROW) page_size = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+        results.push_back(run.finish(steps, 0, (uint64_t)pages * page_size));
+        sqlite3_close(destination);
+    }
+    sqlite3_close(source);
+}
+
+static void bench_serialize(const Options& options, std::vector<Result>& results) {
+    // A private memdb database is one contiguous image, which NOCOPY hands out directly. A plain
+    // :memory: database lives in the page cache and a shared one ("file:/name") is locked, for
+    // both NOCOPY returns null.
+    sqlite3* db = nullptr;
+    check(sqlite3_open_v2("file:sqlite3_gd_bench?vfs=memdb", &db,
+                          SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX | SQLITE_OPEN_URI, nullptr),
+          db, "open memdb");
+    fill_items(db, options.rows);
+    const int repeats = 20;
+
+    {
+        Run run("serialize");
+        run.param("mode", "copy");
+        uint64_t bytes = 0;
+        for (int i = 0; i < repeats; ++i) {
+            sqlite3_int64 size = 0;
+            unsigned char* data = sqlite3_serialize(db, "main", &size, 0);
+            bytes += size;
+            sqlite3_free(data);
+        }
+        results.push_back(run.finish(repeats, 0, bytes));
+    }
+    {
+        Run run("serialize");
+        run.param("mode", "nocopy");
+        uint64_t bytes = 0;
+        for (int i = 0; i < repeats; ++i) {
+            sqlite3_int64 size = 0;
+            unsigned char* data = sqlite3_serialize(db, "main", &size, SQLITE_SERIALIZE_NOCOPY);
+            check(data ? SQLITE_OK : SQLITE_ERROR, db, "serialize nocopy");
+            bytes += size;
+        }
+        results.push_back(run.finish(repeats, 0, bytes));
+    }
+    {
+        sqlite3_int64 size = 0;
+        unsigned char* image = sqlite3_serialize(db, "main", &size, 0);
+        Run run("deserialize");
+        run.param("mode", "freeonclose");
+        for (int i = 0; i < repeats; ++i) {
+            sqlite3* copy = open_db(":memory:");
+            unsigned char* data = static_cast<unsigned char*>(sqlite3_malloc64(size));
+            memcpy(data, image, size);
+            check(sqlite3_deserialize(copy, "main", data, size, size,
+                                      SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE),
+                  copy, "deserialize");
+            exec(copy, "SELECT count(*) FROM items");
+            sqlite3_close(copy);
+        }
+        results.push_back(run.finish(repeats, 0, (uint64_t)size * repeats));
+        sqlite3_free(image);
+    }
+    sqlite3_close(db);
+}
+
+static void bench_wal_concurrency(const Options& options, std::vector<Result>& results) {
+    std::string path = temp_path(options, "wal");
+    {
+        sqlite3* db = open_db(path);
+        exec(db, "PRAGMA journal_mode = WAL");
+        fill_items(db, std::min<int64_t>(options.rows, 100000));
+        sqlite3_close(db);
+    }
+    int64_t table_rows = std::min<int64_t>(options.rows, 100000);
+
+    for (int readers : {1, 2, 4}) {
+        std::atomic<bool> stop(false);
+        std::atomic<uint64_t> reads(0);
+        std::atomic<uint64_t> writes(0);
+        std::vector<std::thread> threads;
+
+        Run run("wal_concurrency");
+        run.param("readers", readers).param("writers", 1);
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+                sqlite3* db = open_db(path);
+                sqlite3_busy_timeout(db, 1000);
+                sqlite3_stmt* stmt = prepare(db, "SELECT value FROM items WHERE id = ?1");
+                std::mt19937_64 random(r);
+                while (!stop) {
+                    sqlite3_bind_int64(stmt, 1, (int64_t)(random() % table_rows) + 1);
+                    while (sqlite3_step(stmt) == SQLITE_ROW) {
+                    }
+                    sqlite3_reset(stmt);
+                    reads.fetch_add(1, std::memory_order_relaxed);
+                }
+                sqlite3_finalize(stmt);
+                sqlite3_close(db);
+            });
+        }
+        threads.emplace_back([&]() {
+            sqlite3* db = open_db(path);
+            sqlite3_busy_timeout(db, 1000);
+            exec(db, "PRAGMA synchronous = NORMAL");
+            sqlite3_stmt* stmt = prepare(db, "UPDATE items SET value = value + 1 WHERE id = ?1");
+            std::mt19937_64 random(99);
+            while (!stop) {
+                // Small transactions, as a game saving state every few frames would
+                exec(db, "BEGIN IMMEDIATE");
+                for (int i = 0; i < 10; ++i) {
+                    sqlite3_bind_int64(stmt, 1, (int64_t)(random() % table_rows) + 1);
+                    sqlite3_step(stmt);
+                    sqlite3_reset(stmt);
+                }
+                exec(db, "COMMIT");
+                writes.fetch_add(10, std::memory_order_relaxed);
+            }
+            sqlite3_finalize(stmt);
+            sqlite3_close(db);
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.duration_ms));
+        stop = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        Result result = run.finish(reads + writes, reads + writes);
+        result.params.emplace_back("reads", std::to_string(reads.load()));
+        result.params.emplace_back("writes", std::to_string(writes.load()));
+        results.push_back(result);
+    }
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+static void bench_vector_topk(const Options& options, std::vector<Result>& results) {
+    const int dims = 128;
+    int64_t count = std::min<int64_t>(options.rows, 50000);
+    sqlite3* db = open_db(":memory:");
+    sqlite3_gd_vector_init(db, nullptr, nullptr);
+    exec(db, "CREATE TABLE items (id INTEGER PRIMARY KEY, embedding BLOB)");
+    exec(db, "BEGIN");
+    sqlite3_stmt* insert = prepare(db, "INSERT INTO items (embedding) VALUES (?1)");
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> vector(dims);
+    for (int64_t i = 0; i < count; ++i) {
+        for (float& x : vector) x = uniform(random);
+        sqlite3_bind_blob(insert, 1, vector.data(), dims * sizeof(float), SQLITE_TRANSIENT);
+        check(sqlite3_step(insert), db, "insert vector");
+        sqlite3_reset(insert);
+    }
+    sqlite3_finalize(insert);
+    exec(db, "COMMIT");
+
+    sqlite3_stmt* query = prepare(db, "SELECT vec_topk(id, embedding, ?1, 10) FROM items");
+    const int queries = 20;
+    Run run("vector_topk");
+    run.param("vectors", count).param("dims", dims).param("kernel", sqlite3_gd_vec::kernel_name());
+    for (int i = 0; i < queries; ++i) {
+        for (float& x : vector) x = uniform(random);
+        Clock::time_point start = Clock::now();
+        sqlite3_bind_blob(query, 1, vector.data(), dims * sizeof(float), SQLITE_TRANSIENT);
+        check(sqlite3_step(query), db, "vec_topk");
+        sqlite3_reset(query);
+        run.result().latency.record(elapsed_ns(start));
+    }
+    results.push_back(run.finish(queries, (uint64_t)count * queries));
+    sqlite3_finalize(query);
+    sqlite3_close(db);
+}
+
+// ---------------------------------------------------------------------------
+// Workload replay
+
+static std::string json_escape(const char* text) {
+    std::string out;
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if ((unsigned char)*c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*c);
+            out += escaped;
+        } else {
+            out += *c;
+        }
+    }
+    return out;
+}
+
+static void write_replay_stats(FILE* out, const sqlite3_gd_workload::ReplayStats& stats) {
+    fprintf(out,
+            "\"executions\": %llu, \"errors\": %llu, \"rows\": %llu, \"total_ns\": %llu, "
+            "\"p50_ns\": %llu, \"p95_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu, "
+            "\"recorded_p50_ns\": %llu, \"recorded_p95_ns\": %llu, \"recorded_p99_ns\": %llu, "
+            "\"recorded_max_ns\": %llu",
+            (unsigned long long)stats.executions, (unsigned long long)stats.errors, (unsigned long long)stats.rows,
+            (unsigned long long)stats.total_ns, (unsigned long long)stats.latency.percentile(0.50),
+            (unsigned long long)stats.latency.percentile(0.95), (unsigned long long)stats.latency.percentile(0.99),
+            (unsigned long long)stats.latency.max(), (unsigned long long)stats.recorded.percentile(0.50),
+            (unsigned long long)stats.recorded.percentile(0.95), (unsigned long long)stats.recorded.percentile(0.99),
+            (unsigned long long)stats.recorded.max());
+}
+
+static int run_replay(const Options& options, FILE* out) {
+    std::ifstream file(options.replay, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "cannot read %s\n", options.replay.c_str());
+        return 1;
+    }
+    std::vector<uint8_t> trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // The trace runs against a copy, so the captured database is left untouched
+    std::string path = options.db.empty() ? std::string(":memory:") : temp_path(options, "replay");
+    sqlite3* db = open_db(path);
+    if (!options.db.empty()) {
+        sqlite3* source = nullptr;
+        check(sqlite3_open_v2(options.db.c_str(), &source, SQLITE_OPEN_READONLY, nullptr), source, "open --db");
+        sqlite3_backup* backup = sqlite3_backup_init(db, "main", source, "main");
+        check(backup ? SQLITE_OK : sqlite3_errcode(db), db, "backup");
+        sqlite3_backup_step(backup, -1);
+        check(sqlite3_backup_finish(backup), db, "backup");
+        sqlite3_close(source);
+    }
+    sqlite3_gd_vector_init(db, nullptr, nullptr);
+    if (!options.setup.empty()) exec(db, options.setup.c_str());
+
+    fprintf(stderr, "replaying %s (%zu bytes)\n", options.replay.c_str(), trace.size());
+    sqlite3_gd_workload::ReplayReport report = sqlite3_gd_workload::replay(db, trace.data(), trace.size(), options.speed);
+    if (report.rc != SQLITE_OK) fprintf(stderr, "replay error: %s\n", report.first_error.c_str());
+
+    fprintf(out, "{\n  \"sqlite_version\": \"%s\",\n  \"trace\": \"%s\",\n  \"rc\": %d,\n", sqlite3_libversion(),
+            json_escape(options.replay.c_str()).c_str(), report.rc);
+    fprintf(out, "  \"first_error\": \"%s\",\n  \"wall_ns\": %llu,\n  \"total\": {",
+            json_escape(report.first_error.c_str()).c_str(), (unsigned long long)report.wall_ns);
+    write_replay_stats(out, report.total);
+    fprintf(out, "},\n  \"statements\": [\n");
+    size_t i = 0;
+    for (const auto& entry : report.per_sql) {
+        fprintf(out, "    {\"sql\": \"%s\", ", json_escape(entry.first.c_str()).c_str());
+        write_replay_stats(out, entry.second);
+        fprintf(out, "}%s\n", ++i < report.per_sql.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+
+    sqlite3_close(db);
+    if (!options.db.empty()) {
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+            std::remove((path + suffix).c_str());
+        }
+    }
+    return report.rc == SQLITE_OK ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Output
+
+static void write_json(FILE* out, const std::vector<Result>& results) {
+    fprintf(out, "{\n  \"sqlite_version\": \"%s\",\n  \"sqlite_source_id\": \"%s\",\n", sqlite3_libversion(),
+            json_escape(sqlite3_sourceid()).c_str());
+    fprintf(out, "  \"compile_options\": [");
+    for (int i = 0; sqlite3_compileoption_get(i); ++i) {
+        fprintf(out, "%s\"%s\"", i ? ", " : "", json_escape(sqlite3_compileoption_get(i)).c_str());
+    }
+    fprintf(out, "],\n  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double seconds = r.total_ns / 1e9;
+        fprintf(out, "    {\"scenario\": \"%s\", \"params\": {", r.scenario.c_str());
+        for (size_t p = 0; p < r.params.size(); ++p) {
+            fprintf(out, "%s\"%s\": %s", p ? ", " : "", r.params[p].first.c_str(), r.params[p].second.c_str());
+        }
+        fprintf(out, "}, \"ops\": %llu, \"ns_per_op\": %.1f, \"ops_per_sec\": %.1f", (unsigned long long)r.ops,
+                r.ops ? (double)r.total_ns / r.ops : 0.0, seconds > 0 ? r.ops / seconds : 0.0);
+        if (r.rows) fprintf(out, ", \"rows_per_sec\": %.1f", seconds > 0 ? r.rows / seconds : 0.0);
+        if (r.bytes) fprintf(out, ", \"mb_per_sec\": %.1f", seconds > 0 ? r.bytes / seconds / 1048576.0 : 0.0);
+        fprintf(out, ", \"allocs_per_op\": %.2f, \"alloc_bytes_per_op\": %.1f", r.ops ? (double)r.allocs / r.ops : 0.0,
+                r.ops ? (double)r.alloc_bytes / r.ops : 0.0);
+        if (r.latency.count()) {
+            fprintf(out, ", \"p50_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu",
+                    (unsigned long long)r.latency.percentile(0.50), (unsigned long long)r.latency.percentile(0.99),
+                    (unsigned long long)r.latency.max());
+        }
+        if (r.rc != SQLITE_OK) fprintf(out, ", \"rc\": %d", r.rc);
+        fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) { return arg.substr(strlen(prefix)); };
+        if (arg.rfind("--filter=", 0) == 0) {
+            options.filter = value("--filter=");
+        } else if (arg.rfind("--rows=", 0) == 0) {
+            options.rows = std::max<int64_t>(100, std::atoll(value("--rows=").c_str()));
+        } else if (arg.rfind("--duration-ms=", 0) == 0) {
+            options.duration_ms = std::max<int64_t>(10, std::atoll(value("--duration-ms=").c_str()));
+        } else if (arg.rfind("--tmpdir=", 0) == 0) {
+            options.tmpdir = value("--tmpdir=");
+        } else if (arg.rfind("--out=", 0) == 0) {
+            options.out = value("--out=");
+        } else if (arg.rfind("--replay=", 0) == 0) {
+            options.replay = value("--replay=");
+        } else if (arg.rfind("--db=", 0) == 0) {
+            options.db = value("--db=");
+        } else if (arg.rfind("--setup=", 0) == 0) {
+            options.setup = value("--setup=");
+        } else if (arg.rfind("--speed=", 0) == 0) {
+            options.speed = std::max(0.0, std::atof(value("--speed=").c_str()));
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--filter=substring] [--rows=N] [--duration-ms=N] [--tmpdir=path] [--out=file.json]\n"
+                    "       %s --replay=trace.gdwl [--db=file.db] [--setup=SQL] [--speed=X] [--out=file.json]\n",
+                    argv[0], argv[0]);
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    install_counting_allocator();
+    sqlite3_initialize();
+
+    FILE* out = options.out.empty() ? stdout : fopen(options.out.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", options.out.c_str());
+        return 1;
+    }
+    if (!options.replay.empty()) {
+        int rc = run_replay(options, out);
+        if (out != stdout) fclose(out);
+        return rc;
+    }
+
+    const std::vector<std::pair<const char*, std::function<void(const Options&, std::vector<Result>&)>>> scenarios = {
+        {"insert", bench_insert},
+        {"point_lookup", bench_point_lookup},
+        {"range_scan", bench_range_scan},
+        {"blob_io", bench_blob_io},
+        {"backup", bench_backup},
+        {"serialize", bench_serialize},
+        {"wal_concurrency", bench_wal_concurrency},
+        {"vector_topk", bench_vector_topk},
+    };
+    std::vector<Result> results;
+    for (const auto& scenario : scenarios) {
+        if (!options.filter.empty() && std::string(scenario.first).find(options.filter) == std::string::npos) continue;
+        fprintf(stderr, "running %s\n", scenario.first);
+        scenario.second(options, results);
+    }
+
+    write_json(out, results);
+    if (out != stdout) fclose(out);
+    return 0;
+}
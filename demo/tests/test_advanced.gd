@@ -37,6 +37,9 @@ func run_test(db: SQLite3Database, log_func: Callable):
 	# Test blob operations
 	test_blobs(db, log_func)
 
+	# Test streaming blob I/O
+	test_blob_streams(db, log_func)
+
 	# Test prepared statements with search
 	test_search(db, log_func)
 
@@ -46,6 +49,24 @@ func run_test(db: SQLite3Database, log_func: Callable):
 	# Test database status
 	test_status(db, log_func)
 
+	# Test asynchronous execution
+	test_async(db, log_func)
+
+	# Test user-defined SQL functions
+	test_functions(db, log_func)
+
+	# Test virtual tables over Godot arrays
+	test_array_module(db, log_func)
+
+	# Test changeset capture and replay
+	test_sessions(db, log_func)
+
+	# Test consistent reads across connections
+	test_snapshots(db, log_func)
+
+	# Test budgeted and background backups
+	test_backup_jobs(db, log_func)
+
 	log_func.call("Advanced Database Features Test completed", "TEST_END")
 
 func test_transactions(db: SQLite3Database, log_func: Callable):
@@ -120,6 +141,58 @@ func test_blobs(db: SQLite3Database, log_func: Callable):
 		log_func.call("Retrieved blob: " + retrieved.get_string_from_utf8(), "INFO")
 	query_stmt.finalize()
 
+func test_blob_streams(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing streaming BLOB I/O", "SUBTEST")
+
+	db.exec("CREATE TABLE assets (id INTEGER PRIMARY KEY, data BLOB)")
+	db.exec("INSERT INTO assets (id, data) VALUES (1, NULL), (2, zeroblob(64))")
+
+	# Import a file in chunks on a worker thread
+	var path = "user://blob_import_test.bin"
+	var source = PackedByteArray()
+	source.resize(600000)
+	for i in source.size():
+		source[i] = (i * 31) % 251
+	var file = FileAccess.open(path, FileAccess.WRITE)
+	file.store_buffer(source)
+	file.close()
+	var result = db.blob_import_async(path, "assets", "data", 1).wait()
+	if result["rc"] != SQLite3Database.SQLITE_OK or result["bytes"] != source.size():
+		log_func.call("blob_import_async failed: " + str(result), "ERROR")
+		return
+
+	# Read it back in chunks, the last one shortened to what is left
+	var blob = db.blob_open("main", "assets", "data", 1, 0)
+	var copy = PackedByteArray()
+	var offset = 0
+	while offset < blob.bytes():
+		var chunk = blob.read(mini(65536, blob.bytes() - offset), offset)
+		if chunk.is_empty():
+			break
+		copy.append_array(chunk)
+		offset += chunk.size()
+	blob.close()
+	if copy == source:
+		log_func.call("Imported " + str(offset) + " bytes and read them back in chunks", "SUCCESS")
+	else:
+		log_func.call("Chunked blob reads returned different bytes", "ERROR")
+
+	# Small typed writes and reads through the StreamPeer adapter
+	var stream = db.blob_open("main", "assets", "data", 2, 1).open_stream(16)
+	for i in 16:
+		stream.put_u32(i * 1000)
+	var overflow = stream.put_data(PackedByteArray([1]))
+	stream.seek(0)
+	var values = []
+	for i in 16:
+		values.append(stream.get_u32())
+	stream.close()
+	if values[15] == 15000 and overflow == ERR_FILE_CANT_WRITE:
+		log_func.call("Blob stream round-tripped 16 values and rejected growth", "SUCCESS")
+	else:
+		log_func.call("Blob stream mismatch: " + str(values) + ", overflow " + str(overflow), "ERROR")
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+
 func test_search(db: SQLite3Database, log_func: Callable):
 	log_func.call("Testing search functionality", "SUBTEST")
 
@@ -150,3 +223,243 @@ func test_status(db: SQLite3Database, log_func: Callable):
 
 	var cache_size = db.exec("PRAGMA cache_size")
 	log_func.call("Cache size: " + str(cache_size), "INFO")
+
+	db.register_monitors("test")
+	db.get_table("SELECT count(*) FROM tasks")
+	var heap = Performance.get_custom_monitor("SQLite3 test/heap_bytes")
+	var registered = Performance.has_custom_monitor("SQLite3 test/statements_per_frame")
+	db.unregister_monitors()
+	if registered and heap > 0 and not Performance.has_custom_monitor("SQLite3 test/heap_bytes"):
+		log_func.call("Performance monitors registered, SQLite heap: %d bytes" % heap, "SUCCESS")
+	else:
+		log_func.call("Performance monitors missing", "ERROR")
+
+	if EngineDebugger.has_profiler("sqlite"):
+		EngineDebugger.profiler_enable("sqlite", true)
+		db.get_table("SELECT count(*) AS traced FROM tasks")
+		var events = SQLite3Database.peek_statement_events()
+		EngineDebugger.profiler_enable("sqlite", false)
+		var traced = events.filter(func(event): return "AS traced" in event[4])
+		if traced.size() == 1 and traced[0][2] == 1:
+			log_func.call("Debugger profiler recorded the query: %s" % str(traced[0]), "SUCCESS")
+		else:
+			log_func.call("Debugger profiler did not record the query: " + str(events), "ERROR")
+	else:
+		log_func.call("Debugger profiler 'sqlite' is not registered", "ERROR")
+
+func test_async(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing asynchronous queries", "SUBTEST")
+
+	var task = db.query_async("SELECT id, title FROM tasks WHERE done = ?", [0])
+	if task == null:
+		log_func.call("Failed to start async query", "ERROR")
+		return
+	task.completed.connect(func(result): log_func.call("Async query completed with %d rows" % result["rows"].size(), "INFO"))
+	var result = task.wait()
+	if result["rc"] == SQLite3Database.SQLITE_OK:
+		log_func.call("Async query returned %d rows, columns: %s" % [result["rows"].size(), str(result["columns"])], "SUCCESS")
+	else:
+		log_func.call("Async query failed: " + result["error"], "ERROR")
+
+	task = db.exec_async("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c")
+	task.cancel()
+	result = task.wait()
+	if result["rc"] == SQLite3Database.SQLITE_INTERRUPT:
+		log_func.call("Async exec cancelled", "SUCCESS")
+	else:
+		log_func.call("Async exec was not cancelled, rc: " + str(result["rc"]), "ERROR")
+
+func test_functions(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing user-defined functions", "SUBTEST")
+
+	var flags = SQLite3Database.SQLITE_DETERMINISTIC | SQLite3Database.SQLITE_INNOCUOUS
+	db.create_function("clamp_priority", 1, func(p): return clampi(p, 0, 3), flags)
+	var rows = db.get_table("SELECT clamp_priority(priority) FROM tasks")
+	log_func.call("Scalar function returned %d rows" % rows.size(), "INFO")
+
+	db.create_aggregate("concat_titles", 1, func(state, title): return state + [title], func(state): return ", ".join(state), flags, [])
+	var stmt = db.prepare("SELECT concat_titles(title) FROM tasks")
+	if stmt.step() == SQLite3Database.SQLITE_ROW:
+		log_func.call("Aggregate result: " + stmt.column_text(0), "INFO")
+	stmt.finalize()
+
+	db.create_window_function("running_sum", 1,
+		func(state, x): return state + x,
+		func(state, x): return state - x,
+		func(state): return state,
+		func(state): return state,
+		flags, 0)
+	stmt = db.prepare("SELECT running_sum(value) OVER (ORDER BY value ROWS BETWEEN 1 PRECEDING AND CURRENT ROW) FROM (SELECT 1 AS value UNION ALL SELECT 2 UNION ALL SELECT 3)")
+	var sums = []
+	while stmt.step() == SQLite3Database.SQLITE_ROW:
+		sums.append(stmt.column_int(0))
+	stmt.finalize()
+	if sums == [1, 3, 5]:
+		log_func.call("Window function results: " + str(sums), "SUCCESS")
+	else:
+		log_func.call("Unexpected window function results: " + str(sums), "ERROR")
+
+	db.remove_function("clamp_priority", 1)
+
+func test_array_module(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing array virtual tables", "SUBTEST")
+
+	var columns = {
+		"unit_id": PackedInt64Array([10, 20, 30]),
+		"hp": PackedFloat32Array([1.0, 0.5, 0.25]),
+		"name": PackedStringArray(["scout", "tank", "medic"]),
+	}
+	if db.create_module("units_view", columns) != SQLite3Database.SQLITE_OK:
+		log_func.call("create_module failed: " + db.errmsg(), "ERROR")
+		return
+
+	var rows = db.get_table("SELECT name FROM units_view WHERE unit_id = 20")
+	if rows.size() == 1 and rows[0][0] == "tank":
+		log_func.call("Column lookup returned " + str(rows), "SUCCESS")
+	else:
+		log_func.call("Unexpected column lookup result: " + str(rows), "ERROR")
+
+	# Columns are shared, so replacing one is visible to the next query
+	columns["name"] = PackedStringArray(["scout", "tank", "healer"])
+	rows = db.get_table("SELECT name FROM units_view WHERE rowid = 2")
+	if rows.size() == 1 and rows[0][0] == "healer":
+		log_func.call("Live update visible through rowid lookup", "SUCCESS")
+	else:
+		log_func.call("Live update not visible: " + str(rows), "ERROR")
+
+	# The native prefilter compares text bytewise, other collations must still match
+	rows = db.get_table("SELECT unit_id FROM units_view WHERE name = 'TANK' COLLATE NOCASE")
+	if rows.size() == 1 and rows[0][0] == "20":
+		log_func.call("NOCASE lookup matched through the prefilter", "SUCCESS")
+	else:
+		log_func.call("NOCASE lookup was filtered out: " + str(rows), "ERROR")
+
+	var loot = [{"owner": 10, "item": "sword"}, {"owner": 30, "item": "potion"}, {"owner": 30, "item": "bandage"}]
+	db.create_module("loot_view", loot)
+	rows = db.get_table("SELECT u.name, count(*) AS n FROM loot_view l JOIN units_view u ON u.unit_id = l.owner GROUP BY u.name ORDER BY n DESC")
+	if rows.size() == 2 and rows[0][1] == "2":
+		log_func.call("Join over array tables: " + str(rows), "SUCCESS")
+	else:
+		log_func.call("Unexpected join result: " + str(rows), "ERROR")
+
+func test_sessions(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing sessions and changesets", "SUBTEST")
+
+	var replica = SQLite3Database.open(":memory:")
+	var schema = "CREATE TABLE inventory (slot INTEGER PRIMARY KEY, item TEXT, qty INTEGER)"
+	db.exec(schema)
+	replica.exec(schema)
+
+	var session = db.session_create()
+	session.attach("inventory")
+	db.exec("INSERT INTO inventory VALUES (1, 'arrow', 20), (2, 'potion', 3)")
+	db.exec("UPDATE inventory SET qty = 19 WHERE slot = 1")
+	var changeset = session.changeset()
+	log_func.call("Changeset of %d bytes, %d changes" % [changeset.size(), SQLite3Database.changeset_changes(changeset).size()], "INFO")
+
+	if replica.changeset_apply(changeset) != SQLite3Database.SQLITE_OK:
+		log_func.call("changeset_apply failed: " + replica.errmsg(), "ERROR")
+		return
+	var stmt = replica.prepare("SELECT qty FROM inventory WHERE slot = 1")
+	if stmt.step() == SQLite3Database.SQLITE_ROW and stmt.column_int(0) == 19:
+		log_func.call("Replica matches after changeset_apply", "SUCCESS")
+	else:
+		log_func.call("Replica does not match the source", "ERROR")
+	stmt.finalize()
+
+	# Record only the next change in a fresh session
+	session.close()
+	session = db.session_create()
+	session.attach("inventory")
+
+	# Local edit on the replica conflicts with the next change, resolved by the callback
+	replica.exec("UPDATE inventory SET qty = 0 WHERE slot = 2")
+	db.exec("UPDATE inventory SET qty = 4 WHERE slot = 2")
+	var delta = session.changeset()
+	var conflicts = []
+	replica.changeset_apply(delta, func(kind, change):
+		conflicts.append(change["table"])
+		return SQLite3Database.SQLITE_CHANGESET_REPLACE)
+	stmt = replica.prepare("SELECT qty FROM inventory WHERE slot = 2")
+	if stmt.step() == SQLite3Database.SQLITE_ROW and stmt.column_int(0) == 4 and conflicts.size() == 1:
+		log_func.call("Conflict resolved by callback", "SUCCESS")
+	else:
+		log_func.call("Unexpected conflict handling: " + str(conflicts), "ERROR")
+	stmt.finalize()
+
+	# Undo everything on the replica with the inverse changeset
+	replica.changeset_apply(SQLite3Database.changeset_invert(delta), SQLite3Database.SQLITE_CHANGESET_OMIT)
+	session.close()
+	replica.close()
+
+func test_snapshots(_db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing WAL snapshots", "SUBTEST")
+
+	var path = "user://snapshot_test.db"
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+	var writer = SQLite3Database.open(path)
+	writer.exec("PRAGMA journal_mode = WAL")
+	writer.exec("CREATE TABLE scores (id INTEGER PRIMARY KEY, points INTEGER)")
+	writer.exec("INSERT INTO scores (points) VALUES (10), (20), (30)")
+
+	var snapshot = writer.snapshot_get()
+	if snapshot == null:
+		log_func.call("snapshot_get failed", "ERROR")
+		writer.close()
+		return
+	writer.exec("INSERT INTO scores (points) VALUES (40)")
+
+	# Both readers see the three rows of the snapshot, not the later insert
+	var counts = []
+	for i in range(2):
+		var reader = SQLite3Database.open(path)
+		if reader.snapshot_open(snapshot) == SQLite3Database.SQLITE_OK:
+			var stmt = reader.prepare("SELECT count(*) FROM scores")
+			stmt.step()
+			counts.append(stmt.column_int(0))
+			stmt.finalize()
+			reader.exec("COMMIT")
+		reader.close()
+
+	var later = writer.snapshot_get()
+	if counts == [3, 3] and SQLite3Database.snapshot_cmp(snapshot, later) < 0:
+		log_func.call("Readers saw the same snapshot state: " + str(counts), "SUCCESS")
+	else:
+		log_func.call("Snapshot reads were inconsistent: " + str(counts), "ERROR")
+	writer.close()
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+
+func test_backup_jobs(_db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing managed backups", "SUBTEST")
+
+	var source = SQLite3Database.open(":memory:")
+	source.exec("CREATE TABLE chunks (id INTEGER PRIMARY KEY, data BLOB)")
+	source.exec("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 2000) INSERT INTO chunks (data) SELECT randomblob(1024) FROM c")
+
+	# Drive the copy in 1 ms slices, as a game loop would
+	var copy = SQLite3Database.open(":memory:")
+	var backup = source.backup_init("main", copy, "main")
+	var slices = 0
+	var rc = SQLite3Database.SQLITE_OK
+	while rc == SQLite3Database.SQLITE_OK:
+		rc = backup.step_for(1000)
+		slices += 1
+	backup.finish()
+	var rows = copy.get_table("SELECT count(*) FROM chunks")
+	if rc == SQLite3Database.SQLITE_DONE and rows[0][0] == "2000":
+		log_func.call("Budgeted backup copied %d pages in %d slices, last step %d pages" % [backup.pagecount(), slices, backup.get_pages_per_step()], "SUCCESS")
+	else:
+		log_func.call("Budgeted backup failed, rc: " + str(rc), "ERROR")
+	copy.close()
+
+	# Background copy, reported through signals once the main loop runs
+	var target = SQLite3Database.open(":memory:")
+	var job = source.backup_init("main", target, "main")
+	job.finished.connect(func(result):
+		var count = target.get_table("SELECT count(*) FROM chunks")
+		if result == SQLite3Database.SQLITE_OK and count[0][0] == "2000":
+			log_func.call("Background backup finished", "SUCCESS")
+		else:
+			log_func.call("Background backup failed, rc: " + str(result), "ERROR"))
+	if job.start(SQLite3Backup.MODE_THREADED, 2000) != SQLite3Database.SQLITE_OK:
+		log_func.call("Failed to start background backup", "ERROR")
@@ -21,6 +21,12 @@ func run_test(db: SQLite3Database, log_func: Callable):
 	# Test memory database persistence
 	test_memory_persistence(db, log_func)
 
+	# Test Godot paths through the godot VFS
+	test_godot_paths(db, log_func)
+
+	# Test query deadlines and the progress handler
+	test_query_deadline(db, log_func)
+
 	log_func.call("Edge Cases Test completed", "TEST_END")
 
 func test_error_handling(db: SQLite3Database, log_func: Callable):
@@ -132,6 +138,103 @@ func test_memory_persistence(db: SQLite3Database, log_func: Callable):
 	# Note: In a real scenario, we'd test with multiple connections,
 	# but since we're using :memory:, data doesn't persist across connections
 
+func test_godot_paths(_db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing user:// and res:// paths", "SUBTEST")
+
+	var path = "user://vfs_test.db"
+	var file_db = SQLite3Database.open(path)
+	if file_db == null:
+		log_func.call("Failed to open " + path, "ERROR")
+		return
+	file_db.exec("CREATE TABLE IF NOT EXISTS t (x INTEGER)")
+	file_db.exec("INSERT INTO t VALUES (42)")
+	file_db.close()
+
+	# Reopen to check the data reached the file
+	file_db = SQLite3Database.open(path)
+	var rows = file_db.get_table("SELECT x FROM t")
+	file_db.close()
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+	if rows.size() > 0:
+		log_func.call("Data persisted through " + path, "SUCCESS")
+	else:
+		log_func.call("No data read back from " + path, "ERROR")
+
+	# Resources are read-only and missing ones must fail cleanly
+	var missing = SQLite3Database.open_v2("res://tests/missing.db", SQLite3Database.SQLITE_OPEN_READONLY)
+	if missing == null:
+		log_func.call("Opening a missing res:// database failed as expected", "INFO")
+	else:
+		log_func.call("Opened a res:// database that does not exist", "ERROR")
+		missing.close()
+
+	# The shipped fixture is 128 KiB: read once from memory, then through the 64 KiB block cache
+	for uri in ["res://tests/fixture.db", "file:res://tests/fixture.db?preload=0"]:
+		var res_db = SQLite3Database.open_v2(uri, SQLite3Database.SQLITE_OPEN_READONLY | SQLite3Database.SQLITE_OPEN_URI)
+		if res_db == null:
+			log_func.call("Failed to open " + uri, "ERROR")
+			continue
+		var summary = res_db.get_table("SELECT count(*), sum(length(payload)), (SELECT payload FROM items WHERE id = 120) FROM items")
+		if summary.size() != 1 or summary[0][0] != "120" or summary[0][1] != "120000" or summary[0][2] != "0120".repeat(250):
+			log_func.call("Unexpected contents read from " + uri, "ERROR")
+		var rc = res_db.exec("INSERT INTO items (name, payload) VALUES ('new', '')")
+		if (rc & 0xff) != SQLite3Database.SQLITE_READONLY:
+			log_func.call("Writing to " + uri + " returned %d instead of SQLITE_READONLY" % rc, "ERROR")
+		else:
+			log_func.call("Read " + uri + " and refused writes", "SUCCESS")
+		res_db.close()
+
+func test_query_deadline(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing query deadlines", "SUBTEST")
+
+	var runaway = "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c"
+	db.set_query_deadline(5000)
+	var start_time = Time.get_ticks_usec()
+	var rc = db.exec(runaway)
+	var elapsed = Time.get_ticks_usec() - start_time
+	var info = db.get_last_interrupt()
+	db.set_query_deadline(0)
+	if rc == SQLite3Database.SQLITE_INTERRUPT and info["reason"] == "deadline":
+		log_func.call("Runaway query stopped after %d usec (%d VM steps recorded)" % [elapsed, info["vm_steps"]], "SUCCESS")
+	else:
+		log_func.call("Deadline did not stop the query, rc: " + str(rc), "ERROR")
+
+	# SQL that starts with a comment is timed like any other statement
+	db.set_query_deadline(5000)
+	rc = db.exec("-- runaway\n" + runaway)
+	db.set_query_deadline(0)
+	if rc != SQLite3Database.SQLITE_INTERRUPT:
+		log_func.call("Deadline missed a statement starting with a comment, rc: " + str(rc), "ERROR")
+
+	# Quick statements are unaffected
+	db.set_query_deadline(5000)
+	rc = db.exec("SELECT count(*) FROM tasks")
+	db.set_query_deadline(0)
+	if rc != SQLite3Database.SQLITE_OK:
+		log_func.call("Deadline interrupted a quick query, rc: " + str(rc), "ERROR")
+
+	# Paging: the time between slices is not counted, nor are leading comments taken for triggers
+	db.set_query_deadline(5000)
+	var pager = db.prepare("-- paged\nWITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 5000) SELECT x FROM c")
+	var first = pager.step_for(1000, 100)
+	OS.delay_usec(10000)
+	var second = pager.step_for(1000, 100)
+	pager.finalize()
+	db.set_query_deadline(0)
+	if first["rc"] != SQLite3Database.SQLITE_OK or second["rc"] != SQLite3Database.SQLITE_OK:
+		log_func.call("Deadline interrupted a paged statement between slices: " + str(second["rc"]), "ERROR")
+
+	var calls = [0]
+	db.progress_handler(10000, func():
+		calls[0] += 1
+		return 1 if calls[0] >= 3 else 0)
+	rc = db.exec(runaway)
+	db.progress_handler(0, Callable())
+	if rc == SQLite3Database.SQLITE_INTERRUPT and calls[0] == 3:
+		log_func.call("Progress handler cancelled the query after %d calls" % calls[0], "SUCCESS")
+	else:
+		log_func.call("Progress handler did not cancel the query, rc: %d, calls: %d" % [rc, calls[0]], "ERROR")
+
 func get_task_count(db: SQLite3Database) -> int:
 	var stmt = db.prepare("SELECT COUNT(*) FROM tasks")
 	if stmt == null:
@@ -9,15 +9,48 @@ func run_test(db: SQLite3Database, log_func: Callable):
 	# Test query performance
 	test_query_performance(db, log_func)
 
+	# Test bulk row fetching
+	test_bulk_fetch(db, log_func)
+
+	# Test frame-budgeted fetching
+	test_budgeted_fetch(db, log_func)
+
 	# Test prepared statement reuse
 	test_prepared_reuse(db, log_func)
 
+	# Test binding whole rows in one call
+	test_bind_all(db, log_func)
+
+	# Test large IN-lists through gd_array()
+	test_bind_array(db, log_func)
+
+	# Test the built-in statement cache
+	test_statement_cache(db, log_func)
+
+	# Test single-call batch execution
+	test_batch_insert(db, log_func)
+
+	# Test parallel readers through a connection pool
+	test_connection_pool(db, log_func)
+
+	# Test native vector similarity functions
+	test_vector_search(db, log_func)
+
 	# Test transaction performance
 	test_transaction_performance(db, log_func)
 
 	# Test index performance
 	test_index_performance(db, log_func)
 
+	# Test saving and loading the database image
+	test_save_load(db, log_func)
+
+	# Test per-SQL latency profiling
+	test_profiling(db, log_func)
+
+	# Test workload capture and replay against a copy
+	test_workload_replay(db, log_func)
+
 	log_func.call("Performance Tests completed", "TEST_END")
 
 func test_bulk_insert(db: SQLite3Database, log_func: Callable):
@@ -54,6 +87,268 @@ func test_query_performance(db: SQLite3Database, log_func: Callable):
 	var rate = count / duration
 	log_func.call("Queried %d rows in %.3f seconds (%.1f rows/sec)" % [count, duration, rate], "PERF")
 
+func test_bulk_fetch(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing bulk fetch performance", "SUBTEST")
+
+	var start_time = Time.get_ticks_usec()
+	var result_set = db.query("SELECT id, data FROM perf_test")
+	var header = result_set.column_names()
+	var rows = result_set.fetch_all()
+	result_set.close()
+	var duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	log_func.call("Fetched %d rows with fetch_all in %.3f seconds (%.1f rows/sec), columns: %s" % [rows.size(), duration, rows.size() / duration, str(header)], "PERF")
+
+	var stmt = db.prepare("SELECT id, data FROM perf_test")
+	var count = 0
+	start_time = Time.get_ticks_usec()
+	while true:
+		var page = stmt.fetch_many(1000)
+		count += page.size()
+		if page.size() < 1000:
+			break
+	stmt.finalize()
+	duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	log_func.call("Fetched %d rows with fetch_many(1000) in %.3f seconds" % [count, duration], "PERF")
+	if count != rows.size():
+		log_func.call("fetch_many and fetch_all disagree: %d vs %d" % [count, rows.size()], "ERROR")
+
+	stmt = db.prepare("SELECT id, data FROM perf_test")
+	start_time = Time.get_ticks_usec()
+	var columnar = stmt.fetch_columns()
+	stmt.finalize()
+	duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	var ids: PackedInt64Array = columnar["columns"][0]
+	log_func.call("Fetched %d rows with fetch_columns in %.3f seconds (id column: %s)" % [columnar["row_count"], duration, type_string(typeof(ids))], "PERF")
+	if ids.size() != rows.size():
+		log_func.call("fetch_columns and fetch_all disagree: %d vs %d" % [ids.size(), rows.size()], "ERROR")
+
+	# Mixed content is returned as it is, not converted to the first value's type
+	db.exec("CREATE TABLE columns_mixed (n INTEGER, t TEXT)")
+	db.exec("INSERT INTO columns_mixed VALUES (1, 'a'), (NULL, NULL), ('abc', 'b'), (1.5, 'c')")
+	stmt = db.prepare("SELECT n, t FROM columns_mixed")
+	var mixed = stmt.fetch_columns()
+	stmt.finalize()
+	db.exec("DROP TABLE columns_mixed")
+	var n_column = mixed["columns"][0]
+	var t_column = mixed["columns"][1]
+	if typeof(n_column) != TYPE_ARRAY or n_column != [1, null, "abc", 1.5]:
+		log_func.call("fetch_columns converted mixed values: " + str(n_column), "ERROR")
+	elif typeof(t_column) != TYPE_PACKED_STRING_ARRAY or mixed["nulls"][1] != PackedByteArray([0, 1, 0, 0]):
+		log_func.call("fetch_columns lost the text column: " + str(t_column), "ERROR")
+
+func test_budgeted_fetch(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing frame-budgeted fetching", "SUBTEST")
+
+	# Page the table in 1 ms slices, as one _process() call per slice would
+	var result_set = db.query("SELECT id, data FROM perf_test")
+	var count = 0
+	var slices = 0
+	var worst_usec = 0
+	while true:
+		var start_time = Time.get_ticks_usec()
+		var chunk = result_set.fetch_for(1000)
+		worst_usec = max(worst_usec, Time.get_ticks_usec() - start_time)
+		count += chunk["rows"].size()
+		slices += 1
+		if chunk["done"]:
+			break
+	result_set.close()
+	log_func.call("Fetched %d rows in %d slices, slowest slice %d usec" % [count, slices, worst_usec], "PERF")
+
+	var stmt = db.prepare("SELECT id FROM perf_test")
+	var limited = stmt.step_for(1000000, 10)
+	stmt.finalize()
+	var expected = db.get_table("SELECT count(*) FROM perf_test")[0][0].to_int()
+	if count == expected and limited["rows"].size() == min(10, expected) and limited["rc"] == SQLite3Database.SQLITE_OK:
+		log_func.call("Budgeted fetch returned every row and honoured the row limit", "SUCCESS")
+	else:
+		log_func.call("Budgeted fetch mismatch: %d of %d rows" % [count, expected], "ERROR")
+
+var _pool: SQLite3ConnectionPool
+var _pool_rows_read := [0, 0, 0, 0]
+
+func _pool_read(index: int):
+	var reader = _pool.acquire_reader()
+	var stmt = reader.prepare("SELECT count(*), sum(length(data)) FROM pool_test WHERE id % 4 = ?")
+	stmt.bind_int(1, index)
+	if stmt.step() == SQLite3Database.SQLITE_ROW:
+		_pool_rows_read[index] = stmt.column_int64(0)
+	stmt.finalize()
+	_pool.release_reader(reader)
+
+func test_connection_pool(_db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing connection pool with parallel readers", "SUBTEST")
+
+	var path = ProjectSettings.globalize_path("user://pool_test.db")
+	_pool = SQLite3ConnectionPool.open(path, 4, PackedStringArray(["PRAGMA cache_size = -4000"]))
+	if _pool == null:
+		log_func.call("Failed to open connection pool", "ERROR")
+		return
+	var writer = _pool.acquire_writer()
+	writer.exec("DROP TABLE IF EXISTS pool_test")
+	writer.exec("CREATE TABLE pool_test (id INTEGER PRIMARY KEY, data TEXT)")
+	var rows = []
+	for i in range(20000):
+		rows.append(["Pool row " + str(i)])
+	writer.execute_batch("INSERT INTO pool_test (data) VALUES (?)", rows)
+	_pool.release_writer(writer)
+
+	var start_time = Time.get_ticks_usec()
+	var group = WorkerThreadPool.add_group_task(_pool_read, 4)
+	WorkerThreadPool.wait_for_group_task_completion(group)
+	var duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	var total = _pool_rows_read.reduce(func(a, b): return a + b, 0)
+	log_func.call("4 pooled readers scanned %d rows in %.3f seconds" % [total, duration], "PERF")
+	log_func.call("Pool stats: " + str(_pool.stats()), "INFO")
+	if total != 20000:
+		log_func.call("Pooled readers saw %d rows instead of 20000" % total, "ERROR")
+
+	var leased = _pool.acquire_reader()
+	if _pool.close() != SQLite3Database.SQLITE_BUSY or leased.exec("SELECT 1") != SQLite3Database.SQLITE_OK:
+		log_func.call("Closing the pool did not refuse while a reader was leased", "ERROR")
+	if _pool.exec_all("PRAGMA cache_size = -2000") != SQLite3Database.SQLITE_BUSY or _pool.busy_timeout(100) != SQLite3Database.SQLITE_BUSY:
+		log_func.call("Configuring the pool did not refuse while a reader was leased", "ERROR")
+	_pool.release_reader(leased)
+	if _pool.busy_timeout(100) != SQLite3Database.SQLITE_OK:
+		log_func.call("Configuring the pool failed once every reader was released", "ERROR")
+
+	_pool.close()
+	_pool = null
+	for suffix in ["", "-wal", "-shm"]:
+		DirAccess.remove_absolute(path + suffix)
+
+func test_bind_all(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing bind_all and bind_named", "SUBTEST")
+
+	db.exec("CREATE TABLE wide_test (a INTEGER, b INTEGER, c REAL, d REAL, e TEXT, f TEXT, g BLOB, h INTEGER)")
+	var count = 5000
+	var stmt = db.prepare("INSERT INTO wide_test VALUES (?, ?, ?, ?, ?, ?, ?, ?)")
+	db.exec("BEGIN")
+	var start_time = Time.get_ticks_usec()
+	for i in range(count):
+		stmt.reset()
+		stmt.bind_int(1, i)
+		stmt.bind_int(2, i * 2)
+		stmt.bind_double(3, i * 0.5)
+		stmt.bind_double(4, i * 0.25)
+		stmt.bind_text(5, "e" + str(i))
+		stmt.bind_text(6, "f" + str(i))
+		stmt.bind_blob(7, PackedByteArray([i % 256]))
+		stmt.bind_int(8, i % 7)
+		stmt.step()
+	var separate = float(Time.get_ticks_usec() - start_time) / 1000000.0
+
+	start_time = Time.get_ticks_usec()
+	for i in range(count):
+		stmt.reset()
+		stmt.bind_all([i, i * 2, i * 0.5, i * 0.25, "e" + str(i), "f" + str(i), PackedByteArray([i % 256]), i % 7])
+		stmt.step()
+	var combined = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	stmt.finalize()
+	db.exec("COMMIT")
+	log_func.call("Bound %d rows x 8 columns: separate calls %.3f s, bind_all %.3f s" % [count, separate, combined], "PERF")
+
+	stmt = db.prepare("SELECT count(*) FROM wide_test WHERE a = :a AND e = :e")
+	stmt.bind_named({"a": 42, ":e": "e42"})
+	if stmt.step() == SQLite3Database.SQLITE_ROW and stmt.column_int(0) == 2:
+		log_func.call("bind_named matched both rows", "SUCCESS")
+	else:
+		log_func.call("bind_named did not match the expected rows", "ERROR")
+	stmt.finalize()
+
+func test_bind_array(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing bind_array IN-lists", "SUBTEST")
+
+	var ids := PackedInt64Array()
+	for i in range(0, 5000, 5):
+		ids.append(i)
+
+	var start_time = Time.get_ticks_usec()
+	var parts := PackedStringArray()
+	for id in ids:
+		parts.append(str(id))
+	var stmt = db.prepare("SELECT count(*) FROM wide_test WHERE a IN (" + ",".join(parts) + ")")
+	stmt.step()
+	var expected = stmt.column_int(0)
+	stmt.finalize()
+	var built = float(Time.get_ticks_usec() - start_time) / 1000000.0
+
+	start_time = Time.get_ticks_usec()
+	stmt = db.prepare("SELECT count(*) FROM wide_test WHERE a IN gd_array(?)")
+	stmt.bind_array(1, ids)
+	stmt.step()
+	var counted = stmt.column_int(0)
+	stmt.finalize()
+	var bound = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	log_func.call("IN-list of %d ids: built SQL %.4f s, bind_array %.4f s" % [ids.size(), built, bound], "PERF")
+
+	if counted == expected and counted > 0:
+		log_func.call("bind_array matched %d rows" % counted, "SUCCESS")
+	else:
+		log_func.call("bind_array matched %d rows, expected %d" % [counted, expected], "ERROR")
+
+	stmt = db.prepare("SELECT group_concat(value) FROM gd_array(?)")
+	stmt.bind_array(1, PackedStringArray(["a", "b", "c"]))
+	if stmt.step() == SQLite3Database.SQLITE_ROW and stmt.column_text(0) == "a,b,c":
+		log_func.call("gd_array() over strings returned elements in order", "SUCCESS")
+	else:
+		log_func.call("gd_array() over strings returned the wrong rows", "ERROR")
+	stmt.finalize()
+
+func _cosine(a: PackedFloat32Array, b: PackedFloat32Array) -> float:
+	var dot := 0.0
+	var na := 0.0
+	var nb := 0.0
+	for i in range(a.size()):
+		dot += a[i] * b[i]
+		na += a[i] * a[i]
+		nb += b[i] * b[i]
+	return dot / (sqrt(na) * sqrt(nb)) if na > 0.0 and nb > 0.0 else 0.0
+
+func test_vector_search(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing native vector similarity search", "SUBTEST")
+
+	var count = 5000
+	var dim = 64
+	var rng = RandomNumberGenerator.new()
+	rng.seed = 42
+	db.exec("CREATE TABLE embeddings (id INTEGER PRIMARY KEY, v BLOB)")
+	var rows = []
+	for i in range(count):
+		var v = PackedFloat32Array()
+		v.resize(dim)
+		for j in range(dim):
+			v[j] = rng.randf_range(-1.0, 1.0)
+		rows.append([v])
+	db.execute_batch("INSERT INTO embeddings (v) VALUES (?)", rows)
+	var query: PackedFloat32Array = rows[123][0]
+
+	# Baseline: fetch everything and score in GDScript
+	var start_time = Time.get_ticks_usec()
+	var best_id = -1
+	var best_score = -2.0
+	for row in db.query("SELECT id, v FROM embeddings").fetch_all():
+		var score = _cosine(row[1].to_float32_array(), query)
+		if score > best_score:
+			best_score = score
+			best_id = row[0]
+	var script_time = float(Time.get_ticks_usec() - start_time) / 1000000.0
+
+	start_time = Time.get_ticks_usec()
+	var stmt = db.prepare("SELECT vec_topk(id, v, ?, 5), vec_kernel() FROM embeddings")
+	stmt.bind_blob(1, query.to_byte_array())
+	stmt.step()
+	var top = JSON.parse_string(stmt.column_text(0))
+	var kernel = stmt.column_text(1)
+	stmt.finalize()
+	var native_time = float(Time.get_ticks_usec() - start_time) / 1000000.0
+
+	log_func.call("Top-5 of %d x %d-d vectors: GDScript %.3f s, vec_topk (%s) %.4f s" % [count, dim, script_time, kernel, native_time], "PERF")
+	if top.size() == 5 and int(top[0]) == best_id and best_id == 124:
+		log_func.call("vec_topk agrees with the GDScript scan", "SUCCESS")
+	else:
+		log_func.call("vec_topk returned %s, GDScript found %d" % [str(top), best_id], "ERROR")
+
 func test_prepared_reuse(db: SQLite3Database, log_func: Callable):
 	log_func.call("Testing prepared statement reuse", "SUBTEST")
 
@@ -73,6 +368,107 @@ func test_prepared_reuse(db: SQLite3Database, log_func: Callable):
 	var rate = count / duration
 	log_func.call("Inserted %d rows with reused statement in %.3f seconds (%.1f inserts/sec)" % [count, duration, rate], "PERF")
 
+func test_statement_cache(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing statement cache", "SUBTEST")
+
+	var before = db.statement_cache_stats()
+	var start_time = Time.get_ticks_usec()
+	var count = 10000
+
+	# Same pattern as test_bulk_insert: the cache turns every prepare after the first into a hit
+	for i in range(count):
+		var stmt = db.prepare("INSERT INTO perf_test (data) VALUES (?)")
+		stmt.bind_text(1, "Cached " + str(i))
+		stmt.step()
+		stmt.finalize()
+
+	var duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	var rate = count / duration
+	var stats = db.statement_cache_stats()
+	var hits = stats["hits"] - before["hits"]
+	log_func.call("Inserted %d rows with cached prepare in %.3f seconds (%.1f inserts/sec)" % [count, duration, rate], "PERF")
+	log_func.call("Statement cache: %d hits, %d misses, %d evictions, %d/%d entries" % [hits, stats["misses"] - before["misses"], stats["evictions"], stats["size"], stats["capacity"]], "INFO")
+	if hits < count - 1:
+		log_func.call("Statement cache missed reusable statements", "ERROR")
+
+	# Two live statements for the same SQL must never share the same handle
+	var first = db.prepare("SELECT COUNT(*) FROM perf_test")
+	var second = db.prepare("SELECT COUNT(*) FROM perf_test")
+	if first.get_instance_id() == second.get_instance_id():
+		log_func.call("Statement cache handed out a statement that is still in use", "ERROR")
+	first.finalize()
+	second.finalize()
+
+	# A statement dropped half-stepped must not stay active inside the cache
+	db.exec("CREATE TABLE cache_test (id INTEGER PRIMARY KEY)")
+	db.exec("INSERT INTO cache_test (id) VALUES (1), (2)")
+	var partial = db.prepare("SELECT id FROM cache_test")
+	partial.step()
+	partial = null
+	if db.exec("DROP TABLE cache_test") != SQLite3Database.SQLITE_OK:
+		log_func.call("Statement cache kept a released statement active", "ERROR")
+
+	# A script authorizer must not hide schema changes from the cache
+	var actions = [0]
+	db.set_authorizer(func(_action, _arg1, _arg2, _db_name, _trigger):
+		actions[0] += 1
+		return SQLite3Database.SQLITE_OK)
+	db.prepare("SELECT COUNT(*) FROM perf_test").finalize()
+	db.exec("CREATE TABLE cache_test (id INTEGER PRIMARY KEY)")
+	db.prepare("SELECT 1").finalize()
+	db.exec("DROP TABLE cache_test")
+	db.set_authorizer(Callable())
+	if actions[0] == 0 or db.statement_cache_stats()["size"] > 1:
+		log_func.call("Statement cache survived a schema change under a script authorizer", "ERROR")
+
+func test_batch_insert(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing batch insert performance", "SUBTEST")
+
+	var count = 10000
+	var rows = []
+	var column = PackedStringArray()
+	for i in range(count):
+		rows.append(["Batch " + str(i)])
+		column.append("Column " + str(i))
+
+	var start_time = Time.get_ticks_usec()
+	var result = db.execute_batch("INSERT INTO perf_test (data) VALUES (?)", rows)
+	var duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	if result["rc"] != SQLite3Database.SQLITE_OK or result["changes"] != count:
+		log_func.call("Batch insert failed: " + str(result), "ERROR")
+	else:
+		log_func.call("Inserted %d rows with execute_batch in %.3f seconds (%.1f inserts/sec)" % [count, duration, count / duration], "PERF")
+
+	start_time = Time.get_ticks_usec()
+	result = db.execute_batch_columns("INSERT INTO perf_test (data) VALUES (?)", [column])
+	duration = float(Time.get_ticks_usec() - start_time) / 1000000.0
+	if result["rc"] != SQLite3Database.SQLITE_OK or result["changes"] != count:
+		log_func.call("Columnar batch insert failed: " + str(result), "ERROR")
+	else:
+		log_func.call("Inserted %d rows with execute_batch_columns in %.3f seconds (%.1f inserts/sec)" % [count, duration, count / duration], "PERF")
+
+	# Non-atomic batches skip failing rows and report them
+	db.exec("CREATE TABLE batch_unique (id INTEGER PRIMARY KEY)")
+	result = db.execute_batch("INSERT INTO batch_unique (id) VALUES (?)", [[1], [2], [1], [3]], false)
+	log_func.call("Non-atomic batch: %d changes, %d errors" % [result["changes"], result["errors"].size()], "INFO")
+	if result["changes"] != 3 or result["errors"].size() != 1 or result["errors"][0]["row"] != 2:
+		log_func.call("Unexpected non-atomic batch result: " + str(result), "ERROR")
+	# Atomic batches roll everything back on the first failure
+	result = db.execute_batch("INSERT INTO batch_unique (id) VALUES (?)", [[4], [1]])
+	if result["rc"] == SQLite3Database.SQLITE_OK or result["changes"] != 0:
+		log_func.call("Atomic batch did not roll back: " + str(result), "ERROR")
+	db.exec("DROP TABLE batch_unique")
+	# A conflict that rolls back the whole transaction ends even a non-atomic batch
+	db.exec("CREATE TABLE batch_abort (id INTEGER PRIMARY KEY ON CONFLICT ROLLBACK)")
+	result = db.execute_batch("INSERT INTO batch_abort (id) VALUES (?)", [[1], [1], [2]], false)
+	if result["rc"] & 0xff != SQLite3Database.SQLITE_CONSTRAINT or result["rows"] != 0 or result["errors"].size() != 1:
+		log_func.call("Aborted batch reported success: " + str(result), "ERROR")
+	db.exec("DROP TABLE batch_abort")
+	# Only one statement is executed per row, so extra statements are rejected
+	result = db.execute_batch("INSERT INTO perf_test (data) VALUES (?); DELETE FROM perf_test", [["x"]])
+	if result["rc"] != SQLite3Database.SQLITE_MISUSE:
+		log_func.call("Batch accepted SQL with several statements: " + str(result), "ERROR")
+
 func test_transaction_performance(db: SQLite3Database, log_func: Callable):
 	log_func.call("Testing transaction performance", "SUBTEST")
 
@@ -108,3 +504,121 @@ func test_index_performance(db: SQLite3Database, log_func: Callable):
 
 	# Clean up
 	db.exec("DROP TABLE perf_test")
+
+func test_save_load(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing save_to_file and load_from_file", "SUBTEST")
+
+	var plain_path = "user://save_test.sqlite"
+	var packed_path = "user://save_test.sav"
+	var saved = db.save_to_file(plain_path)
+	log_func.call("Saved %d bytes via %s in %.3f s" % [saved["bytes"], saved["method"], saved["usec"] / 1000000.0], "PERF")
+
+	var world = SQLite3Database.open(":memory:")
+	var loaded = world.load_from_file(plain_path)
+	log_func.call("Loaded %d bytes in %.3f s" % [loaded["bytes"], loaded["usec"] / 1000000.0], "PERF")
+
+	# The loaded world is one contiguous buffer, saved without any copy
+	var packed = world.save_to_file(packed_path, "main", FileAccess.COMPRESSION_ZSTD)
+	log_func.call("Saved compressed via %s: %d -> %d bytes in %.3f s" % [packed["method"], packed["bytes"], packed["file_bytes"], packed["usec"] / 1000000.0], "PERF")
+
+	var reloaded = SQLite3Database.open(":memory:")
+	reloaded.load_from_file(packed_path)
+	var expected = db.get_table("SELECT count(*) FROM perf_test")
+	var actual = reloaded.get_table("SELECT count(*) FROM perf_test")
+	if loaded["rc"] == SQLite3Database.SQLITE_OK and packed["method"] == "nocopy" and actual == expected:
+		log_func.call("Round trip preserved %s rows" % str(actual[0][0]), "SUCCESS")
+	else:
+		log_func.call("Round trip mismatch: %s vs %s" % [str(actual), str(expected)], "ERROR")
+	if FileAccess.file_exists(packed_path + ".tmp"):
+		log_func.call("Save left its temporary file behind", "ERROR")
+
+	# A header claiming more blocks than the file holds is rejected before allocating
+	var forged_path = "user://save_test_forged.sav"
+	var forged = FileAccess.open(forged_path, FileAccess.WRITE)
+	forged.store_buffer("GDSZ".to_ascii_buffer())
+	forged.store_32(FileAccess.COMPRESSION_ZSTD)
+	forged.store_32(1 << 20)
+	forged.store_64(1 << 40)
+	forged.close()
+	var rejected = SQLite3Database.open(":memory:")
+	if rejected.load_from_file(forged_path)["rc"] != SQLite3Database.SQLITE_CORRUPT:
+		log_func.call("Forged save header was not rejected", "ERROR")
+	rejected.close()
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(forged_path))
+
+	# Unknown compression modes are refused before anything is written
+	if world.save_to_file(packed_path, "main", 42)["rc"] != SQLite3Database.SQLITE_MISUSE:
+		log_func.call("Unknown compression mode was not rejected", "ERROR")
+	elif FileAccess.file_exists(packed_path + ".tmp"):
+		log_func.call("Rejected save still created a temporary file", "ERROR")
+
+	world.close()
+	reloaded.close()
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(plain_path))
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(packed_path))
+
+func test_profiling(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing statement profiling", "SUBTEST")
+
+	# perf_test is dropped by test_index_performance
+	db.exec("CREATE TABLE profile_test (id INTEGER PRIMARY KEY, data TEXT)")
+	db.exec("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 200) INSERT INTO profile_test (data) SELECT 'row ' || x FROM c")
+
+	db.reset_profile()
+	db.enable_profiling()
+	for i in range(200):
+		db.exec("SELECT id, data FROM profile_test WHERE id = %d" % (i + 1))
+	var stmt = db.prepare("SELECT id FROM profile_test LIMIT 50")
+	while stmt.step() == SQLite3Database.SQLITE_ROW:
+		pass
+	stmt.finalize()
+	db.enable_profiling(false)
+
+	var profile = db.get_profile()
+	var lookup = profile.get("SELECT id, data FROM profile_test WHERE id = ?", {})
+	var scan = profile.get("SELECT id FROM profile_test LIMIT ?", {})
+	if lookup.get("calls", 0) == 200 and scan.get("rows", 0) == 50 and lookup.get("p50_usec", 0.0) > 0.0:
+		log_func.call("Point lookup p50 %.1f usec, p99 %.1f usec over %d calls" % [lookup["p50_usec"], lookup["p99_usec"], lookup["calls"]], "PERF")
+		log_func.call("Profile aggregated %d normalized statements" % profile.size(), "SUCCESS")
+	else:
+		log_func.call("Unexpected profile: " + str(profile.keys()), "ERROR")
+	db.exec("DROP TABLE profile_test")
+
+func test_workload_replay(db: SQLite3Database, log_func: Callable):
+	log_func.call("Testing workload capture and replay", "SUBTEST")
+
+	db.exec("CREATE TABLE replay_test (id INTEGER PRIMARY KEY, data TEXT)")
+	db.exec("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 100) INSERT INTO replay_test (data) SELECT 'row ' || x FROM c")
+
+	var path = "user://test_workload.gdwl"
+	if db.start_capture(path) != SQLite3Database.SQLITE_OK or not db.is_capturing():
+		log_func.call("Failed to start capture", "ERROR")
+		return
+	var stmt = db.prepare("SELECT data FROM replay_test WHERE id = ?")
+	for i in range(100):
+		stmt.bind_int(1, i + 1)
+		while stmt.step() == SQLite3Database.SQLITE_ROW:
+			pass
+		stmt.reset()
+	stmt.finalize()
+	db.exec("SELECT count(*) FROM replay_test")
+	var captured = db.stop_capture()
+	if captured.get("executions", 0) != 101 or db.is_capturing():
+		log_func.call("Unexpected capture: " + str(captured), "ERROR")
+		return
+
+	# Replay on an in-memory copy, as a schema or index change would be evaluated
+	var copy = SQLite3Database.open(":memory:")
+	var backup = db.backup_init("main", copy, "main")
+	backup.step(-1)
+	backup.finish()
+	var report = copy.replay_workload(path)
+	var lookup = report.get("statements", {}).get("SELECT data FROM replay_test WHERE id = ?", {})
+	if report.get("rc", -1) == SQLite3Database.SQLITE_OK and report["errors"] == 0 and lookup.get("executions", 0) == 100 and lookup.get("rows", 0) == 100:
+		log_func.call("Replayed %d executions, p99 %.1f usec vs %.1f usec captured" % [report["executions"], report["p99_usec"], report["recorded_p99_usec"]], "PERF")
+		log_func.call("Workload captured (%d bytes) and replayed" % captured["bytes"], "SUCCESS")
+	else:
+		log_func.call("Unexpected replay: " + str(report), "ERROR")
+	copy.close()
+	db.exec("DROP TABLE replay_test")
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
@@ -0,0 +1,663 @@
+#include "SQLite3ArrayModule.h"
+#include "SQLite3Statement.h"
+
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace godot;
+
+// Plans chosen by xBestIndex
+enum ArrayPlan {
+    PLAN_SCAN = 0,
+    PLAN_ROWID_EQ = 1,   // argv[0] is the rowid
+    PLAN_COLUMN_EQ = 2,  // idxStr lists the columns compared to argv[i]
+};
+
+enum ColumnKind {
+    COLUMN_INT32,
+    COLUMN_INT64,
+    COLUMN_FLOAT32,
+    COLUMN_FLOAT64,
+    COLUMN_STRING,
+    COLUMN_VARIANT,  // Array column or a key of a row Dictionary
+};
+
+static bool column_kind_of(Variant::Type type, ColumnKind* kind) {
+    switch (type) {
+        case Variant::Type::PACKED_INT32_ARRAY: *kind = COLUMN_INT32; return true;
+        case Variant::Type::PACKED_INT64_ARRAY: *kind = COLUMN_INT64; return true;
+        case Variant::Type::PACKED_FLOAT32_ARRAY: *kind = COLUMN_FLOAT32; return true;
+        case Variant::Type::PACKED_FLOAT64_ARRAY: *kind = COLUMN_FLOAT64; return true;
+        case Variant::Type::PACKED_STRING_ARRAY: *kind = COLUMN_STRING; return true;
+        case Variant::Type::ARRAY: *kind = COLUMN_VARIANT; return true;
+        default: return false;
+    }
+}
+
+static const char* column_decltype(ColumnKind kind) {
+    switch (kind) {
+        case COLUMN_INT32:
+        case COLUMN_INT64: return " INTEGER";
+        case COLUMN_FLOAT32:
+        case COLUMN_FLOAT64: return " REAL";
+        case COLUMN_STRING: return " TEXT";
+        default: return "";
+    }
+}
+
+// Module client data, owned by SQLite and released through xDestroy
+struct ArraySource {
+    Variant source;
+};
+
+struct ArrayVTab {
+    sqlite3_vtab base;
+    ArraySource* source;
+    bool by_rows;                   // Array of Dictionaries rather than Dictionary of columns
+    std::vector<Variant> keys;      // Dictionary key of every column
+    std::vector<ColumnKind> kinds;  // Fixed when the table is connected
+};
+
+// Read-only view of one column for the duration of a scan
+struct ColumnView {
+    ColumnKind kind = COLUMN_VARIANT;
+    Variant holder;  // Keeps the packed array's storage alive
+    const void* data = nullptr;
+    Array array;
+};
+
+// Equality constraint evaluated natively before SQLite double-checks the row
+struct EqFilter {
+    int column;
+    int type;  // SQLITE_INTEGER, SQLITE_FLOAT or SQLITE_TEXT
+    int64_t i;
+    double d;
+    String s;
+};
+
+struct ArrayCursor {
+    sqlite3_vtab_cursor base;
+    std::vector<ColumnView> columns;
+    Array rows;
+    int64_t row;
+    int64_t end;
+    std::vector<EqFilter> filters;
+};
+
+// Points view at the storage of view.holder and returns its length. The typed copies
+// share the holder's storage, so the pointers stay valid while the holder is alive.
+static int64_t column_view_attach(ColumnView& view, ColumnKind kind) {
+    view.kind = kind;
+    switch (kind) {
+        case COLUMN_INT32: { PackedInt32Array a = view.holder; view.data = a.ptr(); return a.size(); }
+        case COLUMN_INT64: { PackedInt64Array a = view.holder; view.data = a.ptr(); return a.size(); }
+        case COLUMN_FLOAT32: { PackedFloat32Array a = view.holder; view.data = a.ptr(); return a.size(); }
+        case COLUMN_FLOAT64: { PackedFloat64Array a = view.holder; view.data = a.ptr(); return a.size(); }
+        case COLUMN_STRING: { PackedStringArray a = view.holder; view.data = a.ptr(); return a.size(); }
+        default: view.array = view.holder; return view.array.size();
+    }
+}
+
+// Sends a packed value straight to SQLite, false for Variant columns
+static bool column_view_result(const ColumnView& view, int64_t row, sqlite3_context* ctx) {
+    switch (view.kind) {
+        case COLUMN_INT32: sqlite3_result_int64(ctx, static_cast<const int32_t*>(view.data)[row]); return true;
+        case COLUMN_INT64: sqlite3_result_int64(ctx, static_cast<const int64_t*>(view.data)[row]); return true;
+        case COLUMN_FLOAT32: sqlite3_result_double(ctx, static_cast<const float*>(view.data)[row]); return true;
+        case COLUMN_FLOAT64: sqlite3_result_double(ctx, static_cast<const double*>(view.data)[row]); return true;
+        case COLUMN_STRING: {
+            CharString utf8 = static_cast<const String*>(view.data)[row].utf8();
+            sqlite3_result_text(ctx, utf8.get_data(), utf8.length(), SQLITE_TRANSIENT);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static int64_t source_row_count(const ArrayVTab* vtab) {
+    const Variant& source = vtab->source->source;
+    if (vtab->by_rows) {
+        return source.get_type() == Variant::Type::ARRAY ? ((Array)source).size() : 0;
+    }
+    if (source.get_type() != Variant::Type::DICTIONARY) return 0;
+    Dictionary columns = source;
+    int64_t count = -1;
+    for (size_t i = 0; i < vtab->keys.size(); ++i) {
+        Variant column = columns.get(vtab->keys[i], Variant());
+        int64_t size = 0;
+        switch (column.get_type()) {
+            case Variant::Type::PACKED_INT32_ARRAY: size = ((PackedInt32Array)column).size(); break;
+            case Variant::Type::PACKED_INT64_ARRAY: size = ((PackedInt64Array)column).size(); break;
+            case Variant::Type::PACKED_FLOAT32_ARRAY: size = ((PackedFloat32Array)column).size(); break;
+            case Variant::Type::PACKED_FLOAT64_ARRAY: size = ((PackedFloat64Array)column).size(); break;
+            case Variant::Type::PACKED_STRING_ARRAY: size = ((PackedStringArray)column).size(); break;
+            case Variant::Type::ARRAY: size = ((Array)column).size(); break;
+            default: break;
+        }
+        if (count < 0 || size < count) count = size;
+    }
+    return count < 0 ? 0 : count;
+}
+
+static void vtab_error(sqlite3_vtab* vtab, const char* message) {
+    sqlite3_free(vtab->zErrMsg);
+    vtab->zErrMsg = sqlite3_mprintf("%s", message);
+}
+
+// ---------------------------------------------------------------------------
+// Table
+
+static int array_connect(sqlite3* db, void* aux, int, const char* const*, sqlite3_vtab** out, char** err) {
+    ArraySource* source = static_cast<ArraySource*>(aux);
+    ArrayVTab* vtab = memnew(ArrayVTab);
+    memset(&vtab->base, 0, sizeof(vtab->base));
+    vtab->source = source;
+
+    // Collect the columns and their declared types
+    String schema = "CREATE TABLE x(";
+    Array keys;
+    if (source->source.get_type() == Variant::Type::DICTIONARY) {
+        Dictionary columns = source->source;
+        vtab->by_rows = false;
+        keys = columns.keys();
+        for (int i = 0; i < keys.size(); ++i) {
+            ColumnKind kind;
+            if (!column_kind_of(columns[keys[i]].get_type(), &kind)) {
+                *err = sqlite3_mprintf("column %s must be a packed array or an Array", String(keys[i]).utf8().get_data());
+                memdelete(vtab);
+                return SQLITE_ERROR;
+            }
+            vtab->kinds.push_back(kind);
+        }
+    } else if (source->source.get_type() == Variant::Type::ARRAY) {
+        Array rows = source->source;
+        vtab->by_rows = true;
+        if (rows.size() > 0 && rows[0].get_type() == Variant::Type::DICTIONARY) {
+            keys = ((Dictionary)rows[0]).keys();
+        }
+        for (int i = 0; i < keys.size(); ++i) {
+            vtab->kinds.push_back(COLUMN_VARIANT);
+        }
+    }
+    if (keys.is_empty()) {
+        *err = sqlite3_mprintf("source must be a Dictionary of columns or a non-empty Array of Dictionaries");
+        memdelete(vtab);
+        return SQLITE_ERROR;
+    }
+    for (int i = 0; i < keys.size(); ++i) {
+        vtab->keys.push_back(keys[i]);
+        if (i > 0) schema += ",";
+        schema += "\"" + String(keys[i]).replace("\"", "\"\"") + "\"" + column_decltype(vtab->kinds[i]);
+    }
+    schema += ")";
+
+    int rc = sqlite3_declare_vtab(db, schema.utf8().get_data());
+    if (rc != SQLITE_OK) {
+        memdelete(vtab);
+        return rc;
+    }
+    sqlite3_vtab_config(db, SQLITE_VTAB_INNOCUOUS);
+    *out = &vtab->base;
+    return SQLITE_OK;
+}
+
+static int array_disconnect(sqlite3_vtab* base) {
+    memdelete(reinterpret_cast<ArrayVTab*>(base));
+    return SQLITE_OK;
+}
+
+static int array_best_index(sqlite3_vtab* base, sqlite3_index_info* info) {
+    ArrayVTab* vtab = reinterpret_cast<ArrayVTab*>(base);
+    double rows = (double)source_row_count(vtab) + 1.0;
+
+    int rowid_constraint = -1;
+    std::vector<int> eq_constraints;
+    for (int i = 0; i < info->nConstraint; ++i) {
+        const sqlite3_index_info::sqlite3_index_constraint& constraint = info->aConstraint[i];
+        if (!constraint.usable || constraint.op != SQLITE_INDEX_CONSTRAINT_EQ) continue;
+        if (constraint.iColumn < 0) {
+            rowid_constraint = i;
+        } else {
+            eq_constraints.push_back(i);
+        }
+    }
+
+    if (rowid_constraint >= 0) {
+        // Direct index into the arrays
+        info->idxNum = PLAN_ROWID_EQ;
+        info->aConstraintUsage[rowid_constraint].argvIndex = 1;
+        info->estimatedCost = 1.0;
+        info->estimatedRows = 1;
+        info->idxFlags = SQLITE_INDEX_SCAN_UNIQUE;
+    } else if (!eq_constraints.empty()) {
+        // Still a scan, but rows are rejected natively before any value reaches SQLite. Text is
+        // compared bytewise, so a column compared under another collation is marked "c" and its
+        // text values are left to SQLite.
+        String columns;
+        for (size_t i = 0; i < eq_constraints.size(); ++i) {
+            info->aConstraintUsage[eq_constraints[i]].argvIndex = (int)i + 1;
+            if (i > 0) columns += ",";
+            columns += String::num_int64(info->aConstraint[eq_constraints[i]].iColumn);
+            const char* collation = sqlite3_vtab_collation(info, eq_constraints[i]);
+            if (collation && sqlite3_stricmp(collation, "BINARY") != 0) columns += "c";
+        }
+        info->idxNum = PLAN_COLUMN_EQ;
+        info->idxStr = sqlite3_mprintf("%s", columns.utf8().get_data());
+        info->needToFreeIdxStr = 1;
+        info->estimatedCost = rows * 0.5;
+        info->estimatedRows = (sqlite3_int64)(rows / 10.0) + 1;
+    } else {
+        info->idxNum = PLAN_SCAN;
+        info->estimatedCost = rows;
+        info->estimatedRows = (sqlite3_int64)rows;
+    }
+
+    // Rows are produced in rowid order
+    if (info->nOrderBy == 1 && info->aOrderBy[0].iColumn < 0 && !info->aOrderBy[0].desc) {
+        info->orderByConsumed = 1;
+    }
+    return SQLITE_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Cursor
+
+static int array_open(sqlite3_vtab*, sqlite3_vtab_cursor** out) {
+    ArrayCursor* cursor = memnew(ArrayCursor);
+    memset(&cursor->base, 0, sizeof(cursor->base));
+    cursor->row = 0;
+    cursor->end = 0;
+    *out = &cursor->base;
+    return SQLITE_OK;
+}
+
+static int array_close(sqlite3_vtab_cursor* base) {
+    memdelete(reinterpret_cast<ArrayCursor*>(base));
+    return SQLITE_OK;
+}
+
+// Takes the scan's view of the source, returns the row count or -1 after reporting an error
+static int64_t array_snapshot(ArrayVTab* vtab, ArrayCursor* cursor) {
+    cursor->columns.clear();
+    cursor->rows = Array();
+    const Variant& source = vtab->source->source;
+    if (vtab->by_rows) {
+        if (source.get_type() != Variant::Type::ARRAY) {
+            vtab_error(&vtab->base, "source is no longer an Array");
+            return -1;
+        }
+        cursor->rows = source;
+        return cursor->rows.size();
+    }
+
+    if (source.get_type() != Variant::Type::DICTIONARY) {
+        vtab_error(&vtab->base, "source is no longer a Dictionary");
+        return -1;
+    }
+    Dictionary columns = source;
+    int64_t count = -1;
+    cursor->columns.resize(vtab->keys.size());
+    for (size_t i = 0; i < vtab->keys.size(); ++i) {
+        ColumnView& view = cursor->columns[i];
+        view.holder = columns.get(vtab->keys[i], Variant());
+        ColumnKind kind;
+        if (!column_kind_of(view.holder.get_type(), &kind) || kind != vtab->kinds[i]) {
+            vtab_error(&vtab->base, "a column changed type since the module was created");
+            return -1;
+        }
+        int64_t size = column_view_attach(view, kind);
+        if (count < 0 || size < count) count = size;
+    }
+    return count < 0 ? 0 : count;
+}
+
+static Variant array_cell(ArrayVTab* vtab, ArrayCursor* cursor, int column) {
+    if (vtab->by_rows) {
+        Variant row = cursor->rows[cursor->row];
+        if (row.get_type() != Variant::Type::DICTIONARY) return Variant();
+        return ((Dictionary)row).get(vtab->keys[column], Variant());
+    }
+    const ColumnView& view = cursor->columns[column];
+    int64_t row = cursor->row;
+    switch (view.kind) {
+        case COLUMN_INT32: return Variant((int64_t) static_cast<const int32_t*>(view.data)[row]);
+        case COLUMN_INT64: return Variant(static_cast<const int64_t*>(view.data)[row]);
+        case COLUMN_FLOAT32: return Variant((double) static_cast<const float*>(view.data)[row]);
+        case COLUMN_FLOAT64: return Variant(static_cast<const double*>(view.data)[row]);
+        case COLUMN_STRING: return Variant(static_cast<const String*>(view.data)[row]);
+        default: return view.array[row];
+    }
+}
+
+// False only when the row certainly fails an equality constraint. Mismatched types are left
+// to SQLite, which checks every returned row again.
+static bool array_row_matches(ArrayVTab* vtab, ArrayCursor* cursor) {
+    for (const EqFilter& filter : cursor->filters) {
+        if (!vtab->by_rows && filter.type != SQLITE_TEXT) {
+            const ColumnView& view = cursor->columns[filter.column];
+            int64_t row = cursor->row;
+            switch (view.kind) {
+                case COLUMN_INT32:
+                case COLUMN_INT64: {
+                    int64_t value = view.kind == COLUMN_INT32 ? static_cast<const int32_t*>(view.data)[row]
+                                                              : static_cast<const int64_t*>(view.data)[row];
+                    if (filter.type == SQLITE_INTEGER ? value != filter.i : (double)value != filter.d) return false;
+                    continue;
+                }
+                case COLUMN_FLOAT32:
+                case COLUMN_FLOAT64: {
+                    double value = view.kind == COLUMN_FLOAT32 ? static_cast<const float*>(view.data)[row]
+                                                               : static_cast<const double*>(view.data)[row];
+                    if (value != (filter.type == SQLITE_INTEGER ? (double)filter.i : filter.d)) return false;
+                    continue;
+                }
+                default:
+                    break;
+            }
+        }
+        Variant cell = array_cell(vtab, cursor, filter.column);
+        switch (cell.get_type()) {
+            case Variant::Type::INT:
+            case Variant::Type::FLOAT:
+            case Variant::Type::BOOL:
+                if (filter.type == SQLITE_TEXT) continue;
+                if ((double)cell != (filter.type == SQLITE_INTEGER ? (double)filter.i : filter.d)) return false;
+                break;
+            case Variant::Type::STRING:
+            case Variant::Type::STRING_NAME:
+                if (filter.type != SQLITE_TEXT) continue;
+                if (String(cell) != filter.s) return false;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+static void array_skip_to_match(ArrayVTab* vtab, ArrayCursor* cursor) {
+    while (cursor->row < cursor->end && !array_row_matches(vtab, cursor)) {
+        cursor->row++;
+    }
+}
+
+static int array_filter(sqlite3_vtab_cursor* base, int idxNum, const char* idxStr, int argc, sqlite3_value** argv) {
+    ArrayCursor* cursor = reinterpret_cast<ArrayCursor*>(base);
+    ArrayVTab* vtab = reinterpret_cast<ArrayVTab*>(base->pVtab);
+    cursor->filters.clear();
+    int64_t count = array_snapshot(vtab, cursor);
+    if (count < 0) return SQLITE_ERROR;
+    cursor->row = 0;
+    cursor->end = count;
+
+    if (idxNum == PLAN_ROWID_EQ && argc > 0) {
+        int type = sqlite3_value_numeric_type(argv[0]);
+        double value = sqlite3_value_double(argv[0]);
+        int64_t rowid = sqlite3_value_int64(argv[0]);
+        if (type == SQLITE_INTEGER || (type == SQLITE_FLOAT && value == (double)rowid)) {
+            bool inside = rowid >= 0 && rowid < count;
+            cursor->row = inside ? rowid : count;
+            cursor->end = inside ? rowid + 1 : count;
+        }
+        // Any other value is left to SQLite's own comparison over a full scan
+    } else if (idxNum == PLAN_COLUMN_EQ && idxStr) {
+        const char* p = idxStr;
+        for (int i = 0; i < argc && *p; ++i) {
+            EqFilter filter;
+            filter.column = atoi(p);
+            filter.type = sqlite3_value_type(argv[i]);
+            filter.i = sqlite3_value_int64(argv[i]);
+            filter.d = sqlite3_value_double(argv[i]);
+            if (filter.type == SQLITE_NULL) {
+                // Nothing equals NULL
+                cursor->row = cursor->end;
+                return SQLITE_OK;
+            }
+            if (filter.type == SQLITE_TEXT) {
+                filter.s = String::utf8((const char*)sqlite3_value_text(argv[i]), sqlite3_value_bytes(argv[i]));
+            }
+            bool collated = false;
+            while (*p && *p != ',') {
+                if (*p == 'c') collated = true;
+                p++;
+            }
+            if (filter.type != SQLITE_BLOB && !(collated && filter.type == SQLITE_TEXT)) {
+                cursor->filters.push_back(filter);
+            }
+            if (*p == ',') p++;
+        }
+        array_skip_to_match(vtab, cursor);
+    }
+    return SQLITE_OK;
+}
+
+static int array_next(sqlite3_vtab_cursor* base) {
+    ArrayCursor* cursor = reinterpret_cast<ArrayCursor*>(base);
+    cursor->row++;
+    if (!cursor->filters.empty()) {
+        array_skip_to_match(reinterpret_cast<ArrayVTab*>(base->pVtab), cursor);
+    }
+    return SQLITE_OK;
+}
+
+static int array_eof(sqlite3_vtab_cursor* base) {
+    ArrayCursor* cursor = reinterpret_cast<ArrayCursor*>(base);
+    return cursor->row >= cursor->end;
+}
+
+static int array_column(sqlite3_vtab_cursor* base, sqlite3_context* ctx, int column) {
+    ArrayCursor* cursor = reinterpret_cast<ArrayCursor*>(base);
+    ArrayVTab* vtab = reinterpret_cast<ArrayVTab*>(base->pVtab);
+    // Packed columns go straight to SQLite without a Variant in between
+    if (!vtab->by_rows && column_view_result(cursor->columns[column], cursor->row, ctx)) {
+        return SQLITE_OK;
+    }
+    SQLite3Statement::result_variant(ctx, array_cell(vtab, cursor, column));
+    return SQLITE_OK;
+}
+
+static int array_rowid(sqlite3_vtab_cursor* base, sqlite3_int64* rowid) {
+    *rowid = reinterpret_cast<ArrayCursor*>(base)->row;
+    return SQLITE_OK;
+}
+
+static const sqlite3_module array_module = {
+    1,                 // iVersion
+    nullptr,           // xCreate, eponymous-only
+    array_connect,     // xConnect
+    array_best_index,  // xBestIndex
+    array_disconnect,  // xDisconnect
+    array_disconnect,  // xDestroy
+    array_open,        // xOpen
+    array_close,       // xClose
+    array_filter,      // xFilter
+    array_next,        // xNext
+    array_eof,         // xEof
+    array_column,      // xColumn
+    array_rowid,       // xRowid
+    nullptr,           // xUpdate, read-only
+    nullptr,           // xBegin
+    nullptr,           // xSync
+    nullptr,           // xCommit
+    nullptr,           // xRollback
+    nullptr,           // xFindFunction
+    nullptr,           // xRename
+    nullptr,           // xSavepoint
+    nullptr,           // xRelease
+    nullptr,           // xRollbackTo
+    nullptr,           // xShadowName
+    nullptr,           // xIntegrity
+};
+
+static void array_source_destroy(void* aux) {
+    memdelete(static_cast<ArraySource*>(aux));
+}
+
+int sqlite3_gd_create_array_module(sqlite3* db, const char* name, const Variant& source) {
+    ArraySource* aux = memnew(ArraySource);
+    aux->source = source;
+    // SQLite calls array_source_destroy on failure and when the module is replaced or the db is closed
+    return sqlite3_create_module_v2(db, name, &array_module, aux, array_source_destroy);
+}
+
+// ---------------------------------------------------------------------------
+// gd_array(pointer) table-valued function
+
+// Bound through sqlite3_bind_pointer() and released by SQLite with the binding
+struct ArrayPointer {
+    ColumnView view;
+    int64_t size;
+};
+
+struct PointerCursor {
+    sqlite3_vtab_cursor base;
+    const ArrayPointer* array;  // Owned by the statement's binding
+    int64_t row;
+};
+
+enum PointerColumn {
+    POINTER_COLUMN_VALUE = 0,
+    POINTER_COLUMN_POINTER = 1,
+};
+
+static void array_pointer_free(void* pointer) {
+    memdelete(static_cast<ArrayPointer*>(pointer));
+}
+
+static int pointer_connect(sqlite3* db, void*, int, const char* const*, sqlite3_vtab** out, char**) {
+    int rc = sqlite3_declare_vtab(db, "CREATE TABLE x(value, pointer HIDDEN)");
+    if (rc != SQLITE_OK) return rc;
+    sqlite3_vtab* vtab = static_cast<sqlite3_vtab*>(sqlite3_malloc(sizeof(sqlite3_vtab)));
+    if (!vtab) return SQLITE_NOMEM;
+    memset(vtab, 0, sizeof(*vtab));
+    sqlite3_vtab_config(db, SQLITE_VTAB_INNOCUOUS);
+    *out = vtab;
+    return SQLITE_OK;
+}
+
+static int pointer_disconnect(sqlite3_vtab* vtab) {
+    sqlite3_free(vtab);
+    return SQLITE_OK;
+}
+
+static int pointer_best_index(sqlite3_vtab*, sqlite3_index_info* info) {
+    for (int i = 0; i < info->nConstraint; ++i) {
+        const sqlite3_index_info::sqlite3_index_constraint& constraint = info->aConstraint[i];
+        if (constraint.iColumn == POINTER_COLUMN_POINTER && constraint.op == SQLITE_INDEX_CONSTRAINT_EQ) {
+            if (!constraint.usable) continue;
+            info->aConstraintUsage[i].argvIndex = 1;
+            info->aConstraintUsage[i].omit = 1;
+            info->estimatedCost = 1.0;
+            info->estimatedRows = 100;
+            info->idxNum = 1;
+            // Values come out in array order
+            if (info->nOrderBy == 1 && info->aOrderBy[0].iColumn < 0 && !info->aOrderBy[0].desc) {
+                info->orderByConsumed = 1;
+            }
+            return SQLITE_OK;
+        }
+    }
+    // gd_array() is only meaningful with its argument
+    return SQLITE_CONSTRAINT;
+}
+
+static int pointer_open(sqlite3_vtab*, sqlite3_vtab_cursor** out) {
+    PointerCursor* cursor = static_cast<PointerCursor*>(sqlite3_malloc(sizeof(PointerCursor)));
+    if (!cursor) return SQLITE_NOMEM;
+    memset(cursor, 0, sizeof(*cursor));
+    *out = &cursor->base;
+    return SQLITE_OK;
+}
+
+static int pointer_close(sqlite3_vtab_cursor* cursor) {
+    sqlite3_free(cursor);
+    return SQLITE_OK;
+}
+
+static int pointer_filter(sqlite3_vtab_cursor* base, int idxNum, const char*, int argc, sqlite3_value** argv) {
+    PointerCursor* cursor = reinterpret_cast<PointerCursor*>(base);
+    // Anything but a bind_array() binding, including NULL, is an empty table
+    cursor->array = idxNum == 1 && argc > 0
+                        ? static_cast<const ArrayPointer*>(sqlite3_value_pointer(argv[0], SQLITE3_GD_ARRAY_POINTER))
+                        : nullptr;
+    cursor->row = 0;
+    return SQLITE_OK;
+}
+
+static int pointer_next(sqlite3_vtab_cursor* base) {
+    reinterpret_cast<PointerCursor*>(base)->row++;
+    return SQLITE_OK;
+}
+
+static int pointer_eof(sqlite3_vtab_cursor* base) {
+    PointerCursor* cursor = reinterpret_cast<PointerCursor*>(base);
+    return !cursor->array || cursor->row >= cursor->array->size;
+}
+
+static int pointer_column(sqlite3_vtab_cursor* base, sqlite3_context* ctx, int column) {
+    PointerCursor* cursor = reinterpret_cast<PointerCursor*>(base);
+    if (column == POINTER_COLUMN_VALUE) {
+        column_view_result(cursor->array->view, cursor->row, ctx);
+    }
+    return SQLITE_OK;
+}
+
+static int pointer_rowid(sqlite3_vtab_cursor* base, sqlite3_int64* rowid) {
+    *rowid = reinterpret_cast<PointerCursor*>(base)->row;
+    return SQLITE_OK;
+}
+
+static const sqlite3_module pointer_module = {
+    1,                   // iVersion
+    nullptr,             // xCreate, eponymous-only
+    pointer_connect,     // xConnect
+    pointer_best_index,  // xBestIndex
+    pointer_disconnect,  // xDisconnect
+    pointer_disconnect,  // xDestroy
+    pointer_open,        // xOpen
+    pointer_close,       // xClose
+    pointer_filter,      // xFilter
+    pointer_next,        // xNext
+    pointer_eof,         // xEof
+    pointer_column,      // xColumn
+    pointer_rowid,       // xRowid
+    nullptr,             // xUpdate, read-only
+    nullptr,             // xBegin
+    nullptr,             // xSync
+    nullptr,             // xCommit
+    nullptr,             // xRollback
+    nullptr,             // xFindFunction
+    nullptr,             // xRename
+    nullptr,             // xSavepoint
+    nullptr,             // xRelease
+    nullptr,             // xRollbackTo
+    nullptr,             // xShadowName
+    nullptr,             // xIntegrity
+};
+
+int sqlite3_gd_bind_array(sqlite3_stmt* stmt, int index, const Variant& array) {
+    ColumnKind kind;
+    if (!column_kind_of(array.get_type(), &kind) || kind == COLUMN_VARIANT) {
+        return SQLITE_MISMATCH;
+    }
+    ArrayPointer* pointer = memnew(ArrayPointer);
+    pointer->view.holder = array;
+    pointer->size = column_view_attach(pointer->view, kind);
+    // SQLite calls array_pointer_free on failure as well as when the binding goes away
+    return sqlite3_bind_pointer(stmt, index, pointer, SQLITE3_GD_ARRAY_POINTER, array_pointer_free);
+}
+
+int sqlite3_gd_array_init(sqlite3* db, char**, const sqlite3_api_routines*) {
+    return sqlite3_create_module(db, "gd_array", &pointer_module, nullptr);
+}
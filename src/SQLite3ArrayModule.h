@@ -0,0 +1,52 @@
+#ifndef _SQLITE3_ARRAY_MODULE_H
+#define _SQLITE3_ARRAY_MODULE_H
+
+/**
+ * SQLite3ArrayModule.h
+ *
+ * Virtual tables over Godot arrays.
+ *
+ * create_module(name, source) registers an eponymous virtual table that reads
+ * straight from the caller's data, without copying it into SQLite:
+ *
+ *   - a Dictionary of columns, each a PackedInt32Array, PackedInt64Array,
+ *     PackedFloat32Array, PackedFloat64Array, PackedStringArray or Array
+ *   - an Array of Dictionaries, one per row, with the columns taken from the
+ *     keys of the first row
+ *
+ * The rowid is the array index. Dictionaries and Arrays are shared with the
+ * caller, so changes made between queries are visible to the next one.
+ *
+ * gd_array(?) is a table-valued function over a single packed array bound with
+ * SQLite3Statement::bind_array(), in the style of SQLite's carray extension:
+ *
+ *   SELECT * FROM items WHERE id IN gd_array(?1)
+ *
+ * The array is passed to SQLite as a pointer, so large IN-lists need neither
+ * building SQL text nor copying the values.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/variant/variant.hpp>
+
+#include <sqlite3.h>
+
+using namespace godot;
+
+// Registers (or replaces) an eponymous-only module called name over source
+int sqlite3_gd_create_array_module(sqlite3* db, const char* name, const Variant& source);
+
+// Pointer type of gd_array() arguments
+#define SQLITE3_GD_ARRAY_POINTER "gd_array"
+
+// Binds a PackedInt32Array, PackedInt64Array, PackedFloat32Array, PackedFloat64Array or
+// PackedStringArray as a gd_array() argument without copying it
+int sqlite3_gd_bind_array(sqlite3_stmt* stmt, int index, const Variant& array);
+
+// Registers gd_array() on a connection, usable with sqlite3_auto_extension()
+int sqlite3_gd_array_init(sqlite3* db, char** pzErrMsg, const sqlite3_api_routines* pApi);
+
+#endif // _SQLITE3_ARRAY_MODULE_H
@@ -1,12 +1,44 @@
 #include "SQLite3Backup.h"
+#include "SQLite3Database.h"
 
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <algorithm>
 
 using namespace godot;
 
-SQLite3Backup::SQLite3Backup() : _backup(nullptr) {}
+// Pages of the first step, before the copy rate has been measured
+static const int INITIAL_PAGES_PER_STEP = 8;
+static const int MAX_PAGES_PER_STEP = 65536;
+
+// A worker sleeps between slices so other threads can take the connection mutex
+static const int64_t WORKER_YIELD_USEC = 500;
+static const int64_t WORKER_PROGRESS_INTERVAL_USEC = 50000;
+static const int64_t BUSY_BACKOFF_MAX_USEC = 100000;
 
-SQLite3Backup::SQLite3Backup(sqlite3_backup* backup) : _backup(backup) {}
+// Continuous SQLITE_BUSY/SQLITE_LOCKED for this long ends the job with that code
+static const uint64_t BUSY_GIVE_UP_USEC = 30000000;
+
+static uint64_t now_usec() {
+    return Time::get_singleton()->get_ticks_usec();
+}
+
+SQLite3Backup::SQLite3Backup()
+    : _backup(nullptr), _mode(MODE_THREADED), _budget_usec(0), _task_id(-1), _pages_per_step(INITIAL_PAGES_PER_STEP),
+      _usec_per_page(0.0), _busy_since_usec(0), _result(SQLITE_OK), _running(false), _cancelled(false) {}
+
+SQLite3Backup::SQLite3Backup(sqlite3_backup* backup, const Ref<SQLite3Database>& source,
+                             const Ref<SQLite3Database>& destination)
+    : _backup(backup), _source(source), _destination(destination), _mode(MODE_THREADED), _budget_usec(0),
+      _task_id(-1), _pages_per_step(INITIAL_PAGES_PER_STEP), _usec_per_page(0.0), _busy_since_usec(0),
+      _result(SQLITE_OK), _running(false), _cancelled(false) {}
 
 SQLite3Backup::~SQLite3Backup() {
     if (_backup) {
@@ -15,6 +47,7 @@ SQLite3Backup::~SQLite3Backup() {
 }
 
 int SQLite3Backup::step(int nPage) {
+    if (_running) return SQLITE_MISUSE;
     return _backup ? sqlite3_backup_step(_backup, nPage) : SQLITE_MISUSE;
 }
 
@@ -27,15 +60,204 @@ int SQLite3Backup::pagecount() {
 }
 
 int SQLite3Backup::finish() {
-    if (!_backup) return SQLITE_MISUSE;
+    if (!_backup || _running) return SQLITE_MISUSE;
     int rc = sqlite3_backup_finish(_backup);
     _backup = nullptr;
     return rc;
 }
 
+int SQLite3Backup::_step_adaptive(int64_t budget_usec) {
+    // Size the step so it fits the remaining budget at the measured rate
+    int pages = INITIAL_PAGES_PER_STEP;
+    if (_usec_per_page > 0.0) {
+        pages = (int)std::min((double)MAX_PAGES_PER_STEP, std::max(1.0, budget_usec / _usec_per_page));
+    }
+    _pages_per_step = pages;
+
+    int before = sqlite3_backup_remaining(_backup);
+    uint64_t start = now_usec();
+    int rc = sqlite3_backup_step(_backup, pages);
+    uint64_t elapsed = now_usec() - start;
+
+    // The source may have been rewritten and the copy restarted, so count what was requested
+    int copied = rc == SQLITE_DONE ? before : pages;
+    if ((rc == SQLITE_OK || rc == SQLITE_DONE) && copied > 0) {
+        double sample = std::max(1.0, (double)elapsed) / copied;
+        _usec_per_page = _usec_per_page > 0.0 ? 0.75 * _usec_per_page + 0.25 * sample : sample;
+    }
+    return rc;
+}
+
+int SQLite3Backup::_run_slice(int64_t budget_usec) {
+    uint64_t start = now_usec();
+    do {
+        int64_t left = budget_usec - (int64_t)(now_usec() - start);
+        int rc = _step_adaptive(std::max(left, (int64_t)1));
+        if (rc == SQLITE_DONE) return SQLITE_DONE;
+        if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+            uint64_t now = now_usec();
+            if (_busy_since_usec == 0) _busy_since_usec = now;
+            // Try again later, unless the lock has been held for too long
+            return now - _busy_since_usec > BUSY_GIVE_UP_USEC ? rc : SQLITE_OK;
+        }
+        _busy_since_usec = 0;
+        if (rc != SQLITE_OK) return rc;
+    } while ((int64_t)(now_usec() - start) < budget_usec);
+    return SQLITE_OK;
+}
+
+int SQLite3Backup::step_for(int64_t budget_usec) {
+    if (!_backup || _running) return SQLITE_MISUSE;
+    return _run_slice(budget_usec);
+}
+
+int SQLite3Backup::start(int mode, int64_t budget_usec) {
+    if (!_backup || _running || _source.is_null() || _destination.is_null()) return SQLITE_MISUSE;
+    _mode = (Mode)mode;
+    _budget_usec = std::max(budget_usec, (int64_t)100);
+    _cancelled = false;
+    _busy_since_usec = 0;
+
+    if (_mode == MODE_FRAME) {
+        SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+        if (!tree) {
+            UtilityFunctions::printerr("Backup error: frame mode needs a SceneTree");
+            return SQLITE_MISUSE;
+        }
+        _running = true;
+        _self = Ref<SQLite3Backup>(this);
+        tree->connect("process_frame", callable_mp(this, &SQLite3Backup::_on_frame));
+        return SQLITE_OK;
+    }
+
+    _running = true;
+    _self = Ref<SQLite3Backup>(this);
+    // Both handles must stay open until the worker is done with them
+    _source->_track_backup(this, true);
+    _destination->_track_backup(this, true);
+    _task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &SQLite3Backup::_run_worker), false,
+                                                           "SQLite3Backup");
+    return SQLITE_OK;
+}
+
+void SQLite3Backup::_run_worker() {
+    int rc = SQLITE_OK;
+    int64_t backoff = 1000;
+    uint64_t last_progress = 0;
+    while (true) {
+        if (_cancelled) {
+            rc = SQLITE_INTERRUPT;
+            break;
+        }
+        rc = _run_slice(_budget_usec);
+        if (rc != SQLITE_OK) break;
+        if (_busy_since_usec != 0) {
+            OS::get_singleton()->delay_usec(backoff);
+            backoff = std::min(backoff * 2, BUSY_BACKOFF_MAX_USEC);
+            continue;
+        }
+        backoff = 1000;
+        uint64_t now = now_usec();
+        if (now - last_progress >= (uint64_t)WORKER_PROGRESS_INTERVAL_USEC) {
+            last_progress = now;
+            callable_mp(this, &SQLite3Backup::_emit_progress)
+                .call_deferred(sqlite3_backup_remaining(_backup), sqlite3_backup_pagecount(_backup));
+        }
+        OS::get_singleton()->delay_usec(WORKER_YIELD_USEC);
+    }
+
+    int total = sqlite3_backup_pagecount(_backup);
+    int finish_rc = sqlite3_backup_finish(_backup);
+    _backup = nullptr;
+    _result = rc == SQLITE_DONE ? finish_rc : rc;
+    _source->_track_backup(this, false);
+    _destination->_track_backup(this, false);
+
+    // Deliver on the main thread
+    if (_result == SQLITE_OK) callable_mp(this, &SQLite3Backup::_emit_progress).call_deferred(0, total);
+    callable_mp(this, &SQLite3Backup::_finish_job).call_deferred(_result);
+}
+
+void SQLite3Backup::_on_frame() {
+    int rc;
+    if (_cancelled) {
+        rc = SQLITE_INTERRUPT;
+    } else if (!_source->get_db() || !_destination->get_db()) {
+        rc = SQLITE_ABORT;
+    } else {
+        rc = _run_slice(_budget_usec);
+        if (rc == SQLITE_OK) {
+            if (_busy_since_usec == 0) {
+                emit_signal("progress", sqlite3_backup_remaining(_backup), sqlite3_backup_pagecount(_backup));
+            }
+            return;
+        }
+    }
+
+    int total = sqlite3_backup_pagecount(_backup);
+    int finish_rc = sqlite3_backup_finish(_backup);
+    _backup = nullptr;
+    _result = rc == SQLITE_DONE ? finish_rc : rc;
+    if (_result == SQLITE_OK) emit_signal("progress", 0, total);
+    _finish_job(_result);
+}
+
+void SQLite3Backup::_emit_progress(int remaining, int total) {
+    emit_signal("progress", remaining, total);
+}
+
+void SQLite3Backup::_finish_job(int rc) {
+    if (_mode == MODE_FRAME) {
+        SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+        Callable on_frame = callable_mp(this, &SQLite3Backup::_on_frame);
+        if (tree && tree->is_connected("process_frame", on_frame)) {
+            tree->disconnect("process_frame", on_frame);
+        }
+    } else {
+        _join();
+    }
+    _running = false;
+    if (rc != SQLITE_OK && rc != SQLITE_INTERRUPT) {
+        UtilityFunctions::printerr("Backup error: ", String(sqlite3_errstr(rc)));
+    }
+    Ref<SQLite3Backup> keep = _self;
+    _self.unref();
+    emit_signal("finished", rc);
+}
+
+void SQLite3Backup::_join() {
+    if (_task_id < 0) return;
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(_task_id);
+    _task_id = -1;
+}
+
+void SQLite3Backup::cancel() {
+    _cancelled = true;
+}
+
+bool SQLite3Backup::is_running() const {
+    return _running;
+}
+
+int SQLite3Backup::get_pages_per_step() const {
+    return _pages_per_step;
+}
+
 void SQLite3Backup::_bind_methods() {
     ClassDB::bind_method(D_METHOD("step", "nPage"), &SQLite3Backup::step);
     ClassDB::bind_method(D_METHOD("remaining"), &SQLite3Backup::remaining);
     ClassDB::bind_method(D_METHOD("pagecount"), &SQLite3Backup::pagecount);
     ClassDB::bind_method(D_METHOD("finish"), &SQLite3Backup::finish);
-}
\ No newline at end of file
+    ClassDB::bind_method(D_METHOD("start", "mode", "budget_usec"), &SQLite3Backup::start, DEFVAL(MODE_THREADED),
+                         DEFVAL(2000));
+    ClassDB::bind_method(D_METHOD("step_for", "budget_usec"), &SQLite3Backup::step_for);
+    ClassDB::bind_method(D_METHOD("cancel"), &SQLite3Backup::cancel);
+    ClassDB::bind_method(D_METHOD("is_running"), &SQLite3Backup::is_running);
+    ClassDB::bind_method(D_METHOD("get_pages_per_step"), &SQLite3Backup::get_pages_per_step);
+
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("MODE_THREADED"), MODE_THREADED);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("MODE_FRAME"), MODE_FRAME);
+
+    ADD_SIGNAL(MethodInfo("progress", PropertyInfo(Variant::INT, "remaining"), PropertyInfo(Variant::INT, "total")));
+    ADD_SIGNAL(MethodInfo("finished", PropertyInfo(Variant::INT, "rc")));
+}
@@ -7,6 +7,11 @@
  * Godot GDExtension wrapper for SQLite3 backup operations.
  *
  * This class wraps sqlite3_backup* and provides methods for database backup.
+ * Besides the raw step()/remaining()/pagecount() calls, a backup can be run as
+ * a managed job with start(): either on the WorkerThreadPool or in slices of
+ * at most budget_usec per frame. The number of pages per step adapts to the
+ * measured copy rate, SQLITE_BUSY/SQLITE_LOCKED are retried, and progress is
+ * reported through the "progress" and "finished" signals.
  *
  * Original SQLite3 header: <sqlite3.h>
  *
@@ -17,8 +22,12 @@
 
 #include <sqlite3.h>
 
+#include <atomic>
+
 using namespace godot;
 
+class SQLite3Database;
+
 /**
  * SQLite3Backup
  *
@@ -30,13 +39,44 @@ class SQLite3Backup : public RefCounted {
 protected:
     static void _bind_methods();
 
+public:
+    enum Mode {
+        MODE_THREADED,
+        MODE_FRAME,
+    };
+
 private:
     sqlite3_backup* _backup;
+    Ref<SQLite3Database> _source;
+    Ref<SQLite3Database> _destination;
+
+    // Managed job state
+    Ref<SQLite3Backup> _self;  // Keeps the job alive until "finished" was emitted
+    Mode _mode;
+    int64_t _budget_usec;
+    int64_t _task_id;
+    int _pages_per_step;
+    double _usec_per_page;     // Smoothed cost of copying one page
+    uint64_t _busy_since_usec;  // Start of the current run of SQLITE_BUSY/SQLITE_LOCKED, 0 if none
+    int _result;
+    std::atomic<bool> _running;
+    std::atomic<bool> _cancelled;
+
+    int _step_adaptive(int64_t budget_usec);
+    int _run_slice(int64_t budget_usec);
+    void _run_worker();
+    void _on_frame();
+    void _emit_progress(int remaining, int total);
+    void _finish_job(int rc);
+
+public:
+    // Waits for the worker thread of a threaded job, only once
+    void _join();
 
 public:
     // Constructors
     SQLite3Backup();
-    SQLite3Backup(sqlite3_backup* backup);
+    SQLite3Backup(sqlite3_backup* backup, const Ref<SQLite3Database>& source, const Ref<SQLite3Database>& destination);
     virtual ~SQLite3Backup();
 
     // Backup operations
@@ -44,6 +84,13 @@ public:
     int remaining();
     int pagecount();
     int finish();
+
+    // Managed job
+    int start(int mode = MODE_THREADED, int64_t budget_usec = 2000);
+    int step_for(int64_t budget_usec);
+    void cancel();
+    bool is_running() const;
+    int get_pages_per_step() const;
 };
 
-#endif // _SQLITE3_BACKUP_H
\ No newline at end of file
+#endif // _SQLITE3_BACKUP_H
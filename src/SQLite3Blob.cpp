@@ -1,4 +1,5 @@
 #include "SQLite3Blob.h"
+#include "SQLite3BlobStream.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
@@ -19,11 +20,23 @@ int SQLite3Blob::reopen(int64_t iRow) {
     return _blob ? sqlite3_blob_reopen(_blob, iRow) : SQLITE_MISUSE;
 }
 
-PackedByteArray SQLite3Blob::read(int n, int offset) {
+int SQLite3Blob::read_raw(void* buffer, int64_t n, int64_t offset) {
+    if (!_blob) return SQLITE_MISUSE;
+    if (n < 0 || offset < 0 || n + offset > sqlite3_blob_bytes(_blob)) return SQLITE_RANGE;
+    return sqlite3_blob_read(_blob, buffer, (int)n, (int)offset);
+}
+
+int SQLite3Blob::write_raw(const void* buffer, int64_t n, int64_t offset) {
+    if (!_blob) return SQLITE_MISUSE;
+    if (n < 0 || offset < 0 || n + offset > sqlite3_blob_bytes(_blob)) return SQLITE_RANGE;
+    return sqlite3_blob_write(_blob, buffer, (int)n, (int)offset);
+}
+
+PackedByteArray SQLite3Blob::read(int64_t n, int64_t offset) {
     PackedByteArray buffer;
     if (!_blob) return buffer;
     buffer.resize(n);
-    int rc = sqlite3_blob_read(_blob, buffer.ptrw(), n, offset);
+    int rc = read_raw(buffer.ptrw(), n, offset);
     if (rc != SQLITE_OK) {
         UtilityFunctions::printerr("Blob read error: ", String(sqlite3_errstr(rc)));
         buffer.clear();
@@ -31,11 +44,11 @@ PackedByteArray SQLite3Blob::read(int n, int offset) {
     return buffer;
 }
 
-int SQLite3Blob::write(const PackedByteArray& buffer, int offset) {
-    return _blob ? sqlite3_blob_write(_blob, buffer.ptr(), buffer.size(), offset) : SQLITE_MISUSE;
+int SQLite3Blob::write(const PackedByteArray& buffer, int64_t offset) {
+    return write_raw(buffer.ptr(), buffer.size(), offset);
 }
 
-int SQLite3Blob::bytes() {
+int64_t SQLite3Blob::bytes() {
     return _blob ? sqlite3_blob_bytes(_blob) : 0;
 }
 
@@ -46,10 +59,20 @@ int SQLite3Blob::close() {
     return rc;
 }
 
+Ref<SQLite3BlobStream> SQLite3Blob::open_stream(int buffer_size) {
+    if (!_blob) return Ref<SQLite3BlobStream>();
+    return Ref<SQLite3BlobStream>(memnew(SQLite3BlobStream(Ref<SQLite3Blob>(this), buffer_size)));
+}
+
+sqlite3_blob* SQLite3Blob::get_blob() const {
+    return _blob;
+}
+
 void SQLite3Blob::_bind_methods() {
     ClassDB::bind_method(D_METHOD("reopen", "iRow"), &SQLite3Blob::reopen);
     ClassDB::bind_method(D_METHOD("read", "n", "offset"), &SQLite3Blob::read);
     ClassDB::bind_method(D_METHOD("write", "buffer", "offset"), &SQLite3Blob::write);
     ClassDB::bind_method(D_METHOD("bytes"), &SQLite3Blob::bytes);
     ClassDB::bind_method(D_METHOD("close"), &SQLite3Blob::close);
+    ClassDB::bind_method(D_METHOD("open_stream", "buffer_size"), &SQLite3Blob::open_stream, DEFVAL(65536));
 }
\ No newline at end of file
@@ -20,6 +20,8 @@
 
 using namespace godot;
 
+class SQLite3BlobStream;
+
 /**
  * SQLite3Blob
  *
@@ -40,12 +42,20 @@ public:
     SQLite3Blob(sqlite3_blob* blob);
     virtual ~SQLite3Blob();
 
-    // Blob operations
+    // Blob operations. Offsets are 64-bit, but a blob never exceeds SQLite's 2 GiB limit.
     int reopen(int64_t iRow);
-    PackedByteArray read(int n, int offset);
-    int write(const PackedByteArray& buffer, int offset);
-    int bytes();
+    PackedByteArray read(int64_t n, int64_t offset);
+    int write(const PackedByteArray& buffer, int64_t offset);
+    int64_t bytes();
     int close();
+
+    // Buffered StreamPeer over this blob
+    Ref<SQLite3BlobStream> open_stream(int buffer_size = 65536);
+
+    // Raw access for native callers, returns an SQLite result code
+    int read_raw(void* buffer, int64_t n, int64_t offset);
+    int write_raw(const void* buffer, int64_t n, int64_t offset);
+    sqlite3_blob* get_blob() const;
 };
 
 #endif // _SQLITE3_BLOB_H
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "SQLite3BlobStream.h"
+#include "SQLite3Blob.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace godot;
+
+SQLite3BlobStream::SQLite3BlobStream()
+    : _size(0), _position(0), _buffer_size(0), _read_start(0), _read_len(0), _write_start(0), _write_len(0),
+      _last_rc(SQLITE_OK) {}
+
+SQLite3BlobStream::SQLite3BlobStream(const Ref<SQLite3Blob>& blob, int buffer_size)
+    : _blob(blob), _position(0), _buffer_size(std::max(buffer_size, 512)), _read_start(0), _read_len(0),
+      _write_start(0), _write_len(0), _last_rc(SQLITE_OK) {
+    _size = _blob->bytes();
+}
+
+SQLite3BlobStream::~SQLite3BlobStream() {
+    flush();
+}
+
+Error SQLite3BlobStream::_read(uint8_t* buffer, int64_t bytes) {
+    // Reads see pending writes
+    if (_write_len > 0 && flush() != SQLITE_OK) return ERR_FILE_CANT_READ;
+    while (bytes > 0) {
+        if (_position >= _read_start && _position < _read_start + _read_len) {
+            int64_t n = std::min(bytes, _read_start + _read_len - _position);
+            memcpy(buffer, _read_buffer.data() + (_position - _read_start), n);
+            buffer += n;
+            bytes -= n;
+            _position += n;
+            continue;
+        }
+        if (bytes >= _buffer_size) {
+            // Large reads go straight into the caller's buffer
+            _last_rc = _blob->read_raw(buffer, bytes, _position);
+            if (_last_rc != SQLITE_OK) return ERR_FILE_CANT_READ;
+            _position += bytes;
+            return OK;
+        }
+        _read_len = std::min(_buffer_size, _size - _position);
+        _read_start = _position;
+        _read_buffer.resize(_buffer_size);
+        _last_rc = _blob->read_raw(_read_buffer.data(), _read_len, _read_start);
+        if (_last_rc != SQLITE_OK) {
+            _read_len = 0;
+            return ERR_FILE_CANT_READ;
+        }
+    }
+    return OK;
+}
+
+Error SQLite3BlobStream::_write(const uint8_t* data, int64_t bytes) {
+    // Read-ahead overlapping the written range is stale
+    if (_read_len > 0 && _position < _read_start + _read_len && _position + bytes > _read_start) {
+        _read_len = 0;
+    }
+    // Only contiguous writes are coalesced
+    if (_write_len > 0 && _position != _write_start + _write_len && flush() != SQLITE_OK) {
+        return ERR_FILE_CANT_WRITE;
+    }
+    if (_write_len == 0 && bytes >= _buffer_size) {
+        _last_rc = _blob->write_raw(data, bytes, _position);
+        if (_last_rc != SQLITE_OK) return ERR_FILE_CANT_WRITE;
+        _position += bytes;
+        return OK;
+    }
+    if (_write_len == 0) {
+        _write_start = _position;
+        _write_buffer.resize(_buffer_size);
+    }
+    while (bytes > 0) {
+        int64_t n = std::min(bytes, _buffer_size - _write_len);
+        memcpy(_write_buffer.data() + _write_len, data, n);
+        _write_len += n;
+        _position += n;
+        data += n;
+        bytes -= n;
+        if (_write_len == _buffer_size) {
+            if (flush() != SQLITE_OK) return ERR_FILE_CANT_WRITE;
+            _write_start = _position;
+        }
+    }
+    return OK;
+}
+
+int SQLite3BlobStream::flush() {
+    if (_write_len == 0 || _blob.is_null()) return SQLITE_OK;
+    _last_rc = _blob->write_raw(_write_buffer.data(), _write_len, _write_start);
+    if (_last_rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Blob stream write error: ", String(sqlite3_errstr(_last_rc)));
+    }
+    _write_len = 0;
+    return _last_rc;
+}
+
+int SQLite3BlobStream::seek(int64_t position) {
+    if (position < 0 || position > _size) return SQLITE_RANGE;
+    _position = position;
+    return SQLITE_OK;
+}
+
+int64_t SQLite3BlobStream::get_position() const {
+    return _position;
+}
+
+int64_t SQLite3BlobStream::get_length() const {
+    return _size;
+}
+
+bool SQLite3BlobStream::eof_reached() const {
+    return _position >= _size;
+}
+
+int SQLite3BlobStream::close() {
+    int rc = flush();
+    _blob.unref();
+    _size = 0;
+    _position = 0;
+    _read_len = 0;
+    return rc;
+}
+
+int SQLite3BlobStream::get_last_rc() const {
+    return _last_rc;
+}
+
+Error SQLite3BlobStream::_get_data(uint8_t* r_buffer, int32_t r_bytes, int32_t* r_received) {
+    *r_received = 0;
+    if (_blob.is_null()) return ERR_UNAVAILABLE;
+    if (r_bytes > _size - _position) return ERR_FILE_EOF;
+    Error err = _read(r_buffer, r_bytes);
+    if (err == OK) *r_received = r_bytes;
+    return err;
+}
+
+Error SQLite3BlobStream::_get_partial_data(uint8_t* r_buffer, int32_t r_bytes, int32_t* r_received) {
+    *r_received = 0;
+    if (_blob.is_null()) return ERR_UNAVAILABLE;
+    int64_t n = std::min((int64_t)r_bytes, _size - _position);
+    Error err = _read(r_buffer, n);
+    if (err == OK) *r_received = (int32_t)n;
+    return err;
+}
+
+Error SQLite3BlobStream::_put_data(const uint8_t* p_data, int32_t p_bytes, int32_t* r_sent) {
+    *r_sent = 0;
+    if (_blob.is_null()) return ERR_UNAVAILABLE;
+    if (p_bytes > _size - _position) return ERR_FILE_CANT_WRITE;
+    Error err = _write(p_data, p_bytes);
+    if (err == OK) *r_sent = p_bytes;
+    return err;
+}
+
+Error SQLite3BlobStream::_put_partial_data(const uint8_t* p_data, int32_t p_bytes, int32_t* r_sent) {
+    *r_sent = 0;
+    if (_blob.is_null()) return ERR_UNAVAILABLE;
+    int64_t n = std::min((int64_t)p_bytes, _size - _position);
+    Error err = _write(p_data, n);
+    if (err == OK) *r_sent = (int32_t)n;
+    return err;
+}
+
+int32_t SQLite3BlobStream::_get_available_bytes() const {
+    return (int32_t)std::min(_size - _position, (int64_t)INT32_MAX);
+}
+
+void SQLite3BlobStream::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("seek", "position"), &SQLite3BlobStream::seek);
+    ClassDB::bind_method(D_METHOD("get_position"), &SQLite3BlobStream::get_position);
+    ClassDB::bind_method(D_METHOD("get_length"), &SQLite3BlobStream::get_length);
+    ClassDB::bind_method(D_METHOD("eof_reached"), &SQLite3BlobStream::eof_reached);
+    ClassDB::bind_method(D_METHOD("flush"), &SQLite3BlobStream::flush);
+    ClassDB::bind_method(D_METHOD("close"), &SQLite3BlobStream::close);
+    ClassDB::bind_method(D_METHOD("get_last_rc"), &SQLite3BlobStream::get_last_rc);
+}
@@ -0,0 +1,86 @@
+#ifndef _SQLITE3_BLOB_STREAM_H
+#define _SQLITE3_BLOB_STREAM_H
+
+/**
+ * SQLite3BlobStream.h
+ *
+ * StreamPeer adapter over an SQLite3 blob handle.
+ *
+ * Exposes an open SQLite3Blob through the StreamPeer API (get_data, get_u32,
+ * put_data, ...) with a position, read-ahead and write coalescing, so many
+ * small reads or writes cost one sqlite3_blob_read/write per buffer instead
+ * of one each. Blobs have a fixed size, writes past the end fail.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/classes/stream_peer_extension.hpp>
+
+#include <sqlite3.h>
+
+#include <vector>
+
+using namespace godot;
+
+class SQLite3Blob;
+
+/**
+ * SQLite3BlobStream
+ *
+ * Buffered stream over a SQLite3Blob.
+ */
+class SQLite3BlobStream : public StreamPeerExtension {
+    GDCLASS(SQLite3BlobStream, StreamPeerExtension);
+
+protected:
+    static void _bind_methods();
+
+private:
+    Ref<SQLite3Blob> _blob;
+    int64_t _size;
+    int64_t _position;
+    int64_t _buffer_size;
+
+    // Bytes [_read_start, _read_start + _read_len) of the blob
+    std::vector<uint8_t> _read_buffer;
+    int64_t _read_start;
+    int64_t _read_len;
+
+    // Pending bytes for [_write_start, _write_start + _write_len)
+    std::vector<uint8_t> _write_buffer;
+    int64_t _write_start;
+    int64_t _write_len;
+
+    int _last_rc;
+
+    Error _read(uint8_t* buffer, int64_t bytes);
+    Error _write(const uint8_t* data, int64_t bytes);
+
+public:
+    // Constructors
+    SQLite3BlobStream();
+    SQLite3BlobStream(const Ref<SQLite3Blob>& blob, int buffer_size);
+    virtual ~SQLite3BlobStream();
+
+    // Stream position
+    int seek(int64_t position);
+    int64_t get_position() const;
+    int64_t get_length() const;
+    bool eof_reached() const;
+
+    // Writes pending bytes to the blob, returns an SQLite result code
+    int flush();
+    int close();
+    int get_last_rc() const;
+
+    // StreamPeer
+    virtual Error _get_data(uint8_t* r_buffer, int32_t r_bytes, int32_t* r_received) override;
+    virtual Error _get_partial_data(uint8_t* r_buffer, int32_t r_bytes, int32_t* r_received) override;
+    virtual Error _put_data(const uint8_t* p_data, int32_t p_bytes, int32_t* r_sent) override;
+    virtual Error _put_partial_data(const uint8_t* p_data, int32_t p_bytes, int32_t* r_sent) override;
+    virtual int32_t _get_available_bytes() const override;
+};
+
+#endif // _SQLITE3_BLOB_STREAM_H
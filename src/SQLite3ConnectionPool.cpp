@@ -0,0 +1,285 @@
+#include "SQLite3ConnectionPool.h"
+#include "SQLite3Database.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <chrono>
+
+using namespace godot;
+
+static uint64_t pool_now_usec() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void atomic_store_max(std::atomic<int64_t>& target, int64_t value) {
+    int64_t current = target.load();
+    while (value > current && !target.compare_exchange_weak(current, value)) {}
+}
+
+SQLite3ConnectionPool::SQLite3ConnectionPool()
+    : _stats_start(pool_now_usec()), _acquires(0), _waits(0), _timeouts(0),
+      _wait_usec(0), _max_wait_usec(0), _busy_usec(0), _in_use(0), _peak_in_use(0) {}
+
+SQLite3ConnectionPool::~SQLite3ConnectionPool() {
+    close();
+}
+
+Ref<SQLite3ConnectionPool> SQLite3ConnectionPool::open(const String& filename, int reader_count,
+                                                       const PackedStringArray& setup_sql, int flags) {
+    if (filename.is_empty() || filename.begins_with(":memory:") || reader_count < 1) {
+        UtilityFunctions::printerr("Connection pool error: ", "a database file and at least one reader are required");
+        return Ref<SQLite3ConnectionPool>();
+    }
+    if (flags == 0) flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+
+    Ref<SQLite3ConnectionPool> pool = Ref<SQLite3ConnectionPool>(memnew(SQLite3ConnectionPool));
+    pool->_filename = filename;
+
+    // The writer switches the file to WAL before any reader attaches, read-only
+    // connections cannot change the journal mode themselves
+    pool->_writer = SQLite3Database::open_v2(filename, flags | SQLITE_OPEN_FULLMUTEX);
+    if (pool->_writer.is_null()) return Ref<SQLite3ConnectionPool>();
+    if (pool->_writer->exec("PRAGMA journal_mode=WAL") != SQLITE_OK) {
+        return Ref<SQLite3ConnectionPool>();
+    }
+
+    // Readers are leased to one thread at a time and need no mutex of their own
+    int reader_flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX | (flags & SQLITE_OPEN_URI);
+    for (int i = 0; i < reader_count; ++i) {
+        Ref<SQLite3Database> reader = SQLite3Database::open_v2(filename, reader_flags);
+        if (reader.is_null()) return Ref<SQLite3ConnectionPool>();
+        pool->_readers.push_back(reader);
+    }
+
+    pool->_lease_start.reset(new std::atomic<uint64_t>[reader_count]);
+    pool->_free_writer.slots.push_back(0);
+    for (int i = reader_count - 1; i >= 0; --i) {
+        pool->_lease_start[i] = 0;
+        pool->_free_readers.slots.push_back(i);
+    }
+
+    for (int i = 0; i < setup_sql.size(); ++i) {
+        if (pool->exec_all(setup_sql[i]) != SQLITE_OK) return Ref<SQLite3ConnectionPool>();
+    }
+    return pool;
+}
+
+int SQLite3ConnectionPool::close() {
+    // Held throughout, so no reader can be leased while the connections close
+    std::lock_guard<std::mutex> lock(_free_readers.mutex);
+    if (_in_use > 0) {
+        // Closing would pull the handle from under the thread using it
+        UtilityFunctions::printerr("Connection pool error: ", "closing while readers are leased");
+        return SQLITE_BUSY;
+    }
+    int rc = SQLITE_OK;
+    for (int i = 0; i < _readers.size(); ++i) {
+        int reader_rc = _readers[i]->close_v2();
+        if (reader_rc != SQLITE_OK) rc = reader_rc;
+    }
+    _readers.clear();
+    if (_writer.is_valid()) {
+        int writer_rc = _writer->close_v2();
+        if (writer_rc != SQLITE_OK) rc = writer_rc;
+        _writer.unref();
+    }
+    _free_readers.slots.clear();
+    return rc;
+}
+
+int SQLite3ConnectionPool::exec_all(const String& sql) {
+    if (_writer.is_null()) return SQLITE_MISUSE;
+    // Readers have no mutex of their own, a leased one may be running a statement right now.
+    // Holding the lock keeps the idle ones from being leased meanwhile.
+    std::lock_guard<std::mutex> lock(_free_readers.mutex);
+    if (_in_use > 0) {
+        UtilityFunctions::printerr("Connection pool error: ", "configuring while readers are leased");
+        return SQLITE_BUSY;
+    }
+    int rc = _writer->exec(sql);
+    for (int i = 0; rc == SQLITE_OK && i < _readers.size(); ++i) {
+        rc = _readers[i]->exec(sql);
+    }
+    return rc;
+}
+
+int SQLite3ConnectionPool::busy_timeout(int ms) {
+    if (_writer.is_null()) return SQLITE_MISUSE;
+    std::lock_guard<std::mutex> lock(_free_readers.mutex);
+    if (_in_use > 0) {
+        UtilityFunctions::printerr("Connection pool error: ", "configuring while readers are leased");
+        return SQLITE_BUSY;
+    }
+    int rc = _writer->busy_timeout(ms);
+    for (int i = 0; rc == SQLITE_OK && i < _readers.size(); ++i) {
+        rc = _readers[i]->busy_timeout(ms);
+    }
+    return rc;
+}
+
+void SQLite3ConnectionPool::FreeSlots::push(int slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots.push_back(slot);
+    }
+    available.notify_one();
+}
+
+int SQLite3ConnectionPool::FreeSlots::pop(std::unique_lock<std::mutex>& lock, int64_t timeout_usec) {
+    if (timeout_usec < 0) {
+        available.wait(lock, [this] { return !slots.empty(); });
+    } else if (!available.wait_for(lock, std::chrono::microseconds(timeout_usec), [this] { return !slots.empty(); })) {
+        return -1;
+    }
+    int slot = slots.back();
+    slots.pop_back();
+    return slot;
+}
+
+int SQLite3ConnectionPool::_take_slot(FreeSlots& free, std::unique_lock<std::mutex>& lock, int64_t timeout_usec) {
+    if (!free.slots.empty() || timeout_usec == 0) return free.pop(lock, 0);
+
+    uint64_t start = pool_now_usec();
+    _waits++;
+    int slot = free.pop(lock, timeout_usec);
+    int64_t waited = (int64_t)(pool_now_usec() - start);
+    _wait_usec += waited;
+    atomic_store_max(_max_wait_usec, waited);
+    if (slot < 0) _timeouts++;
+    return slot;
+}
+
+int SQLite3ConnectionPool::_slot_of(const Ref<SQLite3Database>& reader) const {
+    for (int i = 0; i < _readers.size(); ++i) {
+        if (_readers[i] == reader) return i;
+    }
+    return -1;
+}
+
+Ref<SQLite3Database> SQLite3ConnectionPool::acquire_reader(int64_t timeout_usec) {
+    if (_readers.is_empty()) return Ref<SQLite3Database>();
+    int slot;
+    {
+        std::unique_lock<std::mutex> lock(_free_readers.mutex);
+        slot = _take_slot(_free_readers, lock, timeout_usec);
+        if (slot < 0) return Ref<SQLite3Database>();
+        _lease_start[slot] = pool_now_usec();
+        _acquires++;
+        int in_use = ++_in_use;
+        if (in_use > _peak_in_use) _peak_in_use = in_use;
+    }
+    // Readers have no mutex, trace changes wait until one is leased
+    _readers[slot]->_apply_deferred_trace();
+    return _readers[slot];
+}
+
+void SQLite3ConnectionPool::release_reader(const Ref<SQLite3Database>& reader) {
+    int slot = _slot_of(reader);
+    if (slot < 0 || _lease_start[slot] == 0) {
+        UtilityFunctions::printerr("Connection pool error: ", "released connection is not a leased reader of this pool");
+        return;
+    }
+    // Leave no read transaction open on a pooled connection, it would pin the WAL. A statement
+    // stepped part of the way holds one even in autocommit mode, so those are reset too.
+    sqlite3* db = reader->get_db();
+    for (sqlite3_stmt* stmt = sqlite3_next_stmt(db, nullptr); stmt; stmt = sqlite3_next_stmt(db, stmt)) {
+        if (sqlite3_stmt_busy(stmt)) sqlite3_reset(stmt);
+    }
+    if (!reader->get_autocommit()) reader->exec("ROLLBACK");
+    {
+        std::lock_guard<std::mutex> lock(_free_readers.mutex);
+        _busy_usec += (int64_t)(pool_now_usec() - _lease_start[slot].exchange(0));
+        _in_use--;
+        _free_readers.slots.push_back(slot);
+    }
+    _free_readers.available.notify_one();
+}
+
+Ref<SQLite3Database> SQLite3ConnectionPool::acquire_writer(int64_t timeout_usec) {
+    if (_writer.is_null()) return Ref<SQLite3Database>();
+    std::unique_lock<std::mutex> lock(_free_writer.mutex);
+    if (_take_slot(_free_writer, lock, timeout_usec) < 0) return Ref<SQLite3Database>();
+    return _writer;
+}
+
+void SQLite3ConnectionPool::release_writer(const Ref<SQLite3Database>& writer) {
+    if (writer.is_null() || writer != _writer) {
+        UtilityFunctions::printerr("Connection pool error: ", "released connection is not the writer of this pool");
+        return;
+    }
+    _free_writer.push(0);
+}
+
+Ref<SQLite3Database> SQLite3ConnectionPool::get_writer() const {
+    return _writer;
+}
+
+int SQLite3ConnectionPool::reader_count() const {
+    return _readers.size();
+}
+
+int SQLite3ConnectionPool::readers_in_use() const {
+    return _in_use;
+}
+
+String SQLite3ConnectionPool::get_filename() const {
+    return _filename;
+}
+
+Dictionary SQLite3ConnectionPool::stats() const {
+    uint64_t now = pool_now_usec();
+    int64_t busy = _busy_usec;
+    for (int i = 0; i < _readers.size(); ++i) {
+        uint64_t start = _lease_start[i];
+        if (start != 0) busy += (int64_t)(now - start);
+    }
+    double capacity = (double)(now - _stats_start) * _readers.size();
+
+    Dictionary result;
+    result["readers"] = _readers.size();
+    result["in_use"] = _in_use.load();
+    result["peak_in_use"] = _peak_in_use.load();
+    result["acquires"] = _acquires.load();
+    result["waits"] = _waits.load();
+    result["timeouts"] = _timeouts.load();
+    result["wait_usec"] = _wait_usec.load();
+    result["max_wait_usec"] = _max_wait_usec.load();
+    result["utilization"] = capacity > 0.0 ? (double)busy / capacity : 0.0;
+    return result;
+}
+
+void SQLite3ConnectionPool::reset_stats() {
+    uint64_t now = pool_now_usec();
+    _stats_start = now;
+    _acquires = 0;
+    _waits = 0;
+    _timeouts = 0;
+    _wait_usec = 0;
+    _max_wait_usec = 0;
+    _busy_usec = 0;
+    _peak_in_use = _in_use.load();
+    // Outstanding leases only count from now on
+    for (int i = 0; i < _readers.size(); ++i) {
+        if (_lease_start[i] != 0) _lease_start[i] = now;
+    }
+}
+
+void SQLite3ConnectionPool::_bind_methods() {
+    ClassDB::bind_static_method("SQLite3ConnectionPool", D_METHOD("open", "filename", "reader_count", "setup_sql", "flags"),
+                                &SQLite3ConnectionPool::open, DEFVAL(4), DEFVAL(PackedStringArray()), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("close"), &SQLite3ConnectionPool::close);
+    ClassDB::bind_method(D_METHOD("exec_all", "sql"), &SQLite3ConnectionPool::exec_all);
+    ClassDB::bind_method(D_METHOD("busy_timeout", "ms"), &SQLite3ConnectionPool::busy_timeout);
+    ClassDB::bind_method(D_METHOD("acquire_reader", "timeout_usec"), &SQLite3ConnectionPool::acquire_reader, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("release_reader", "reader"), &SQLite3ConnectionPool::release_reader);
+    ClassDB::bind_method(D_METHOD("acquire_writer", "timeout_usec"), &SQLite3ConnectionPool::acquire_writer, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("release_writer", "writer"), &SQLite3ConnectionPool::release_writer);
+    ClassDB::bind_method(D_METHOD("get_writer"), &SQLite3ConnectionPool::get_writer);
+    ClassDB::bind_method(D_METHOD("reader_count"), &SQLite3ConnectionPool::reader_count);
+    ClassDB::bind_method(D_METHOD("readers_in_use"), &SQLite3ConnectionPool::readers_in_use);
+    ClassDB::bind_method(D_METHOD("get_filename"), &SQLite3ConnectionPool::get_filename);
+    ClassDB::bind_method(D_METHOD("stats"), &SQLite3ConnectionPool::stats);
+    ClassDB::bind_method(D_METHOD("reset_stats"), &SQLite3ConnectionPool::reset_stats);
+}
@@ -0,0 +1,109 @@
+#ifndef _SQLITE3_CONNECTION_POOL_H
+#define _SQLITE3_CONNECTION_POOL_H
+
+/**
+ * SQLite3ConnectionPool.h
+ *
+ * Godot GDExtension pool of connections to one database file.
+ *
+ * The pool owns one read-write connection and N read-only connections, so
+ * that several threads can read in parallel in WAL mode while another one
+ * writes. Readers are leased from a stack of free slots guarded by a mutex,
+ * which waiting threads sleep on through a condition variable.
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/templates/vector.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace godot;
+
+class SQLite3Database;
+
+/**
+ * SQLite3ConnectionPool
+ *
+ * One writer plus N readers opened with open_v2() on the same file.
+ */
+class SQLite3ConnectionPool : public RefCounted {
+    GDCLASS(SQLite3ConnectionPool, RefCounted);
+
+protected:
+    static void _bind_methods();
+
+private:
+    // Free connection slots with a timed wait, which godot::Semaphore lacks
+    struct FreeSlots {
+        std::mutex mutex;
+        std::condition_variable available;
+        std::vector<int> slots;
+
+        void push(int slot);
+        // Negative waits forever, returns -1 on timeout. Called with the lock held.
+        int pop(std::unique_lock<std::mutex>& lock, int64_t timeout_usec);
+    };
+
+    String _filename;
+    Ref<SQLite3Database> _writer;
+    Vector<Ref<SQLite3Database>> _readers;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> _lease_start;  // usec, per slot
+    FreeSlots _free_readers;
+    FreeSlots _free_writer;  // Slot 0 while the writer is not leased
+
+    // Statistics
+    uint64_t _stats_start;
+    std::atomic<int64_t> _acquires;
+    std::atomic<int64_t> _waits;
+    std::atomic<int64_t> _timeouts;
+    std::atomic<int64_t> _wait_usec;
+    std::atomic<int64_t> _max_wait_usec;
+    std::atomic<int64_t> _busy_usec;
+    std::atomic<int> _in_use;  // Changed under _free_readers.mutex
+    std::atomic<int> _peak_in_use;
+
+    int _take_slot(FreeSlots& free, std::unique_lock<std::mutex>& lock, int64_t timeout_usec);
+    int _slot_of(const Ref<SQLite3Database>& reader) const;
+
+public:
+    // Constructors
+    SQLite3ConnectionPool();
+    virtual ~SQLite3ConnectionPool();
+
+    // Open pool (static factory)
+    static Ref<SQLite3ConnectionPool> open(const String& filename, int reader_count = 4,
+                                           const PackedStringArray& setup_sql = PackedStringArray(), int flags = 0);
+
+    // Close all connections
+    int close();
+
+    // Configuration applied to every connection, only while no reader is leased
+    int exec_all(const String& sql);
+    int busy_timeout(int ms);
+
+    // Leasing
+    Ref<SQLite3Database> acquire_reader(int64_t timeout_usec = -1);
+    void release_reader(const Ref<SQLite3Database>& reader);
+    Ref<SQLite3Database> acquire_writer(int64_t timeout_usec = -1);
+    void release_writer(const Ref<SQLite3Database>& writer);
+    Ref<SQLite3Database> get_writer() const;
+
+    // Info
+    int reader_count() const;
+    int readers_in_use() const;
+    String get_filename() const;
+    Dictionary stats() const;
+    void reset_stats();
+};
+
+#endif // _SQLITE3_CONNECTION_POOL_H
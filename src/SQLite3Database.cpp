@@ -3,13 +3,39 @@
 #include "SQLite3ResultSet.h"
 #include "SQLite3Backup.h"
 #include "SQLite3Blob.h"
+#include "SQLite3Task.h"
+#include "SQLite3Session.h"
+#include "SQLite3Snapshot.h"
+#include "SQLite3GodotVFS.h"
+#include "SQLite3ArrayModule.h"
+#include "SQLite3Profiler.h"
+#include "SQLite3DebuggerProfiler.h"
+#include "SQLite3Workload.h"
 
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/variant/string_name.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
 using namespace godot;
 
+// VM instructions between two deadline checks, a few microseconds of work
+static const int DEADLINE_CHECK_OPS = 1000;
+
+static uint64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 // Callback functions
 static int busy_handler_callback(void* user_data, int count) {
     SQLite3Database* db = static_cast<SQLite3Database*>(user_data);
@@ -52,11 +78,346 @@ static unsigned int autovacuum_pages_callback(void* user_data, const char* db_na
     return SQLITE_OK;
 }
 
-SQLite3Database::SQLite3Database() : _db(nullptr) {}
+// Statement a call from script is about to step again on this thread. The wrapper does not know its
+// connection, so the next callback of that connection, on the same thread and under its mutex,
+// restarts the statement's deadline.
+static thread_local sqlite3_stmt* resumed_stmt = nullptr;
+static thread_local uint64_t resumed_ns = 0;
+
+static void take_resumed_statement(SQLite3Database* db) {
+    if (!resumed_stmt) return;
+    SQLite3Database::RunningStatement* running = db->_running_stmts.getptr(resumed_stmt);
+    if (!running) return;
+    // Before its start the call was the first step, or the address belonged to a finalized statement
+    if (resumed_ns > running->start_ns) {
+        running->resumed_ns = resumed_ns;
+        db->_stmt_running = resumed_stmt;
+    }
+    resumed_stmt = nullptr;
+}
+
+static void record_interrupt(SQLite3Database* db, const char* reason) {
+    Dictionary info;
+    sqlite3_stmt* stmt = db->_stmt_running;
+    const SQLite3Database::RunningStatement* running = stmt ? db->_running_stmts.getptr(stmt) : nullptr;
+    info["reason"] = String(reason);
+    info["sql"] = running ? String::utf8(sqlite3_sql(stmt)) : String();
+    info["elapsed_usec"] = running ? (int64_t)((monotonic_ns() - running->resumed_ns) / 1000) : (int64_t)0;
+    info["vm_steps"] = running ? sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 0) : 0;
+    db->_last_interrupt = info;
+}
+
+static int progress_handler_callback(void* user_data) {
+    SQLite3Database* db = static_cast<SQLite3Database*>(user_data);
+    // The deadline is checked natively, script is only called every _progress_ops instructions
+    if (db->_query_deadline_usec > 0) take_resumed_statement(db);
+    if (db->_query_deadline_usec > 0 && db->_stmt_running) {
+        const SQLite3Database::RunningStatement* running = db->_running_stmts.getptr(db->_stmt_running);
+        if (running && monotonic_ns() - running->resumed_ns >= (uint64_t)db->_query_deadline_usec * 1000) {
+            record_interrupt(db, "deadline");
+            return 1;
+        }
+    }
+    // Script only runs on the main thread, statements of exec_async() and query_async() skip the handler
+    OS* os = OS::get_singleton();
+    if (db->_progress_handler.is_valid() && os->get_thread_caller_id() == os->get_main_thread_id()) {
+        db->_progress_ops_pending += db->_progress_period;
+        if (db->_progress_ops_pending >= db->_progress_ops) {
+            db->_progress_ops_pending = 0;
+            if (db->_progress_handler.call().operator int() != 0) {
+                record_interrupt(db, "handler");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Serves the query deadline, profiling, monitors, debugger events and workload capture, a connection has a
+// single trace callback.
+// Trace events are delivered with the connection mutex held.
+static int trace_callback(unsigned int type, void* user_data, void* p, void* x) {
+    SQLite3Database* db = static_cast<SQLite3Database*>(user_data);
+    sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+    sqlite3_gd_prof::Profiler* profiler = db->_profiling ? db->_profiler.get() : nullptr;
+    bool events = sqlite3_gd_prof::events_enabled();
+    sqlite3_gd_workload::Recorder* recorder = db->_recorder.get();
+    if (db->_query_deadline_usec > 0) take_resumed_statement(db);
+    if (type == SQLITE_TRACE_STMT) {
+        // Trigger programs report their own text and belong to the running statement
+        if (static_cast<const char*>(x) == sqlite3_sql(stmt)) {
+            db->_stmt_running = stmt;
+            SQLite3Database::RunningStatement& running = db->_running_stmts[stmt];
+            running.start_ns = monotonic_ns();
+            running.resumed_ns = running.start_ns;
+            running.rows = 0;
+            if (profiler) profiler->on_stmt(stmt);
+            if (recorder) recorder->on_stmt(stmt);
+        }
+    } else if (type == SQLITE_TRACE_ROW) {
+        if (profiler) profiler->on_row(stmt);
+        if (recorder) recorder->on_row(stmt);
+        SQLite3Database::RunningStatement* running = db->_running_stmts.getptr(stmt);
+        if (running) running->rows++;
+    } else if (type == SQLITE_TRACE_PROFILE) {
+        // Emitted when a statement finishes, is reset or finalized
+        // SQLite's own estimate only has the resolution of the VFS clock, usually a millisecond, so
+        // it is used only for statements that started before tracing did
+        SQLite3Database::RunningStatement* running = db->_running_stmts.getptr(stmt);
+        uint64_t elapsed_ns = running ? monotonic_ns() - running->start_ns : (uint64_t)*static_cast<sqlite3_int64*>(x);
+        uint64_t rows = running ? running->rows : 0;
+        if (running) db->_running_stmts.erase(stmt);
+        if (stmt == db->_stmt_running) {
+            // Back to the statement resumed last, the one a finished nested statement ran inside
+            db->_stmt_running = nullptr;
+            uint64_t latest = 0;
+            for (const KeyValue<sqlite3_stmt*, SQLite3Database::RunningStatement>& it : db->_running_stmts) {
+                if (it.value.resumed_ns >= latest) {
+                    latest = it.value.resumed_ns;
+                    db->_stmt_running = it.key;
+                }
+            }
+        }
+        if (profiler) profiler->on_profile(stmt, elapsed_ns);
+        if (recorder) recorder->on_profile(stmt);
+        if (events) {
+            sqlite3_gd_prof::record_event(Time::get_singleton()->get_ticks_usec(), elapsed_ns, rows, sqlite3_sql(stmt));
+        }
+        if (db->_monitoring) {
+            db->_statements_run.fetch_add(1, std::memory_order_relaxed);
+            db->_statements_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+        }
+    }
+    return 0;
+}
+
+// Conflict handling for changeset_apply(). on_conflict is either a fixed SQLITE_CHANGESET_*
+// action or a Callable(conflict_type, change_info) returning one.
+struct ChangesetApply {
+    Variant on_conflict;
+    Callable filter;
+};
+
+static int changeset_filter_callback(void* user_data, const char* table) {
+    ChangesetApply* apply = static_cast<ChangesetApply*>(user_data);
+    return apply->filter.call(String::utf8(table)).booleanize() ? 1 : 0;
+}
+
+static int changeset_conflict_callback(void* user_data, int conflict, sqlite3_changeset_iter* iter) {
+    ChangesetApply* apply = static_cast<ChangesetApply*>(user_data);
+    int action = SQLITE_CHANGESET_ABORT;
+    if (apply->on_conflict.get_type() == Variant::Type::CALLABLE) {
+        bool with_values = conflict == SQLITE_CHANGESET_DATA || conflict == SQLITE_CHANGESET_CONFLICT;
+        Dictionary info = SQLite3Session::change_info(iter, with_values);
+        action = (int)((Callable)apply->on_conflict).call(conflict, info);
+    } else if (apply->on_conflict.get_type() == Variant::Type::INT) {
+        action = (int)apply->on_conflict;
+    }
+    // REPLACE is only valid for DATA and CONFLICT, skip the change otherwise
+    if (action == SQLITE_CHANGESET_REPLACE && conflict != SQLITE_CHANGESET_DATA && conflict != SQLITE_CHANGESET_CONFLICT) {
+        action = SQLITE_CHANGESET_OMIT;
+    }
+    return action;
+}
+
+// User-defined SQL functions. One UserFunction is owned by SQLite per registered name/arity
+// and destroyed through xDestroy. Its argument Array is reused across calls, so a row costs
+// no Array allocation, only the Variant conversions of its arguments.
+struct UserFunction {
+    Callable func;     // Scalar: func(args...) -> result
+    Callable step;     // Aggregate/window: step(state, args...) -> state
+    Callable inverse;  // Window: inverse(state, args...) -> state
+    Callable value;    // Window: value(state) -> result
+    Callable final;    // Aggregate/window: final(state) -> result
+    Variant initial;   // Initial aggregate state
+    Array args;
+};
+
+static void user_function_destroy(void* user_data) {
+    memdelete(static_cast<UserFunction*>(user_data));
+}
+
+// Fills fn->args from argv, leaving the first offset slots for the caller
+static Array& user_function_args(UserFunction* fn, int offset, int argc, sqlite3_value** argv) {
+    if (fn->args.size() != offset + argc) fn->args.resize(offset + argc);
+    for (int i = 0; i < argc; ++i) {
+        fn->args[offset + i] = SQLite3Statement::value_variant(argv[i]);
+    }
+    return fn->args;
+}
+
+static void user_function_scalar(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    UserFunction* fn = static_cast<UserFunction*>(sqlite3_user_data(ctx));
+    SQLite3Statement::result_variant(ctx, fn->func.callv(user_function_args(fn, 0, argc, argv)));
+}
 
-SQLite3Database::SQLite3Database(sqlite3* db) : _db(db) {}
+// Aggregate state, allocated on first step and released by xFinal
+static Variant* user_function_state(sqlite3_context* ctx, bool create) {
+    Variant** state = static_cast<Variant**>(sqlite3_aggregate_context(ctx, create ? sizeof(Variant*) : 0));
+    if (!state) return nullptr;
+    if (!*state && create) {
+        *state = memnew(Variant(static_cast<UserFunction*>(sqlite3_user_data(ctx))->initial));
+    }
+    return *state;
+}
+
+static void user_function_step(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    UserFunction* fn = static_cast<UserFunction*>(sqlite3_user_data(ctx));
+    Variant* state = user_function_state(ctx, true);
+    if (!state) {
+        sqlite3_result_error_nomem(ctx);
+        return;
+    }
+    Array& args = user_function_args(fn, 1, argc, argv);
+    args[0] = *state;
+    *state = fn->step.callv(args);
+}
+
+static void user_function_inverse(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    UserFunction* fn = static_cast<UserFunction*>(sqlite3_user_data(ctx));
+    Variant* state = user_function_state(ctx, true);
+    if (!state) {
+        sqlite3_result_error_nomem(ctx);
+        return;
+    }
+    Array& args = user_function_args(fn, 1, argc, argv);
+    args[0] = *state;
+    *state = fn->inverse.callv(args);
+}
+
+static void user_function_value(sqlite3_context* ctx) {
+    UserFunction* fn = static_cast<UserFunction*>(sqlite3_user_data(ctx));
+    Variant* state = user_function_state(ctx, false);
+    SQLite3Statement::result_variant(ctx, fn->value.call(state ? *state : fn->initial));
+}
+
+static void user_function_final(sqlite3_context* ctx) {
+    UserFunction* fn = static_cast<UserFunction*>(sqlite3_user_data(ctx));
+    Variant* state = user_function_state(ctx, false);
+    SQLite3Statement::result_variant(ctx, fn->final.call(state ? *state : fn->initial));
+    if (state) memdelete(state);
+}
+
+// Flags the statement cache as stale whenever this connection compiles a schema change, then defers
+// to the script authorizer if one is set. The cache is flushed lazily on the next lookup (statements
+// cannot be finalized from here).
+static int stmt_cache_authorizer_callback(void* user_data, int action, const char* arg1, const char* arg2,
+                                          const char* db_name, const char* trigger) {
+    SQLite3Database* db = static_cast<SQLite3Database*>(user_data);
+    switch (action) {
+        case SQLITE_CREATE_INDEX:
+        case SQLITE_CREATE_TABLE:
+        case SQLITE_CREATE_TEMP_INDEX:
+        case SQLITE_CREATE_TEMP_TABLE:
+        case SQLITE_CREATE_TEMP_TRIGGER:
+        case SQLITE_CREATE_TEMP_VIEW:
+        case SQLITE_CREATE_TRIGGER:
+        case SQLITE_CREATE_VIEW:
+        case SQLITE_CREATE_VTABLE:
+        case SQLITE_DROP_INDEX:
+        case SQLITE_DROP_TABLE:
+        case SQLITE_DROP_TEMP_INDEX:
+        case SQLITE_DROP_TEMP_TABLE:
+        case SQLITE_DROP_TEMP_TRIGGER:
+        case SQLITE_DROP_TEMP_VIEW:
+        case SQLITE_DROP_TRIGGER:
+        case SQLITE_DROP_VIEW:
+        case SQLITE_DROP_VTABLE:
+        case SQLITE_ALTER_TABLE:
+        case SQLITE_ATTACH:
+        case SQLITE_DETACH:
+            db->_stmt_cache_stale = true;
+            break;
+        default:
+            break;
+    }
+    if (db->_authorizer.is_valid()) {
+        // Arguments that do not apply to the action are NULL
+        auto text = [](const char* value) { return value ? String::utf8(value) : String(); };
+        return db->_authorizer.call(action, text(arg1), text(arg2), text(db_name), text(trigger)).operator int();
+    }
+    return SQLITE_OK;
+}
+
+static const int DEFAULT_STATEMENT_CACHE_SIZE = 64;
+
+// Connections opened by this wrapper, so tracing can be switched for all of them
+static std::mutex open_databases_mutex;
+static HashSet<SQLite3Database*> open_databases;
+
+// Open connections with a query deadline, so resuming a statement costs nothing without one
+static std::atomic<int> deadline_databases(0);
+
+// Connections waiting for a deferred trace change, so stepping a statement costs nothing without one
+static std::atomic<int> stale_trace_databases(0);
+
+static void forget_database(SQLite3Database* db) {
+    std::lock_guard<std::mutex> lock(open_databases_mutex);
+    open_databases.erase(db);
+    if (db->_trace_stale.exchange(false)) stale_trace_databases--;
+    if (db->_query_deadline_usec > 0) {
+        deadline_databases--;
+        db->_query_deadline_usec = 0;
+    }
+}
+
+void SQLite3Database::_update_all_traces() {
+    std::lock_guard<std::mutex> lock(open_databases_mutex);
+    for (SQLite3Database* db : open_databases) {
+        if (!db->_db) continue;
+        if (sqlite3_db_mutex(db->_db)) {
+            db->_update_trace();
+        } else if (!db->_trace_stale.exchange(true)) {
+            stale_trace_databases++;
+        }
+    }
+}
+
+void SQLite3Database::_apply_stale_trace() {
+    if (!_trace_stale.exchange(false)) return;
+    stale_trace_databases--;
+    if (_db) _update_trace();
+}
+
+void SQLite3Database::_resume_statement(sqlite3_stmt* stmt) {
+    if (!stmt) return;
+    if (stale_trace_databases.load(std::memory_order_relaxed) > 0) {
+        // A statement stepped again, e.g. on a pool reader leased before the change, only knows its handle.
+        // The caller may hold a connection mutex inside a callback, which _update_all_traces() takes after
+        // this lock, so a busy lock is skipped and the next step tries again.
+        sqlite3* handle = sqlite3_db_handle(stmt);
+        std::unique_lock<std::mutex> lock(open_databases_mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            for (SQLite3Database* db : open_databases) {
+                if (db->_db == handle) {
+                    db->_apply_deferred_trace();
+                    break;
+                }
+            }
+        }
+    }
+    if (deadline_databases.load(std::memory_order_relaxed) == 0) return;
+    resumed_stmt = stmt;
+    resumed_ns = monotonic_ns();
+}
+
+SQLite3Database::SQLite3Database()
+    : _db(nullptr), _stmt_cache_capacity(DEFAULT_STATEMENT_CACHE_SIZE), _stmt_cache_hits(0), _stmt_cache_misses(0),
+      _stmt_cache_evictions(0), _progress_ops(0), _progress_ops_pending(0), _progress_period(0),
+      _query_deadline_usec(0), _stmt_running(nullptr), _profiling(false), _monitoring(false),
+      _statements_run(0), _statements_ns(0), _capture_start_usec(0), _trace_stale(false), _stmt_cache_stale(false) {}
+
+SQLite3Database::SQLite3Database(sqlite3* db)
+    : _db(db), _stmt_cache_capacity(DEFAULT_STATEMENT_CACHE_SIZE), _stmt_cache_hits(0), _stmt_cache_misses(0),
+      _stmt_cache_evictions(0), _progress_ops(0), _progress_ops_pending(0), _progress_period(0),
+      _query_deadline_usec(0), _stmt_running(nullptr), _profiling(false), _monitoring(false),
+      _statements_run(0), _statements_ns(0), _capture_start_usec(0), _trace_stale(false), _stmt_cache_stale(false) {}
 
 SQLite3Database::~SQLite3Database() {
+    forget_database(this);
+    unregister_monitors();
+    stop_capture();
+    clear_statement_cache();
     if (_db) {
         sqlite3_close_v2(_db);
         _db = nullptr;
@@ -64,6 +425,10 @@ SQLite3Database::~SQLite3Database() {
 }
 
 Ref<SQLite3Database> SQLite3Database::open(const String& filename, int flags, const String& vfs) {
+    if (SQLite3GodotVFS::is_godot_path(filename)) {
+        // sqlite3_open() always uses the default VFS, Godot paths need ours
+        return open_v2(filename, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, vfs);
+    }
     sqlite3* db;
     int rc = sqlite3_open(filename.utf8().get_data(), &db);
     if (rc != SQLITE_OK) {
@@ -71,29 +436,121 @@ Ref<SQLite3Database> SQLite3Database::open(const String& filename, int flags, co
         sqlite3_close(db);
         return Ref<SQLite3Database>();
     }
-    return Ref<SQLite3Database>(memnew(SQLite3Database(db)));
+    Ref<SQLite3Database> result = Ref<SQLite3Database>(memnew(SQLite3Database(db)));
+    result->_on_open();
+    return result;
 }
 
 Ref<SQLite3Database> SQLite3Database::open_v2(const String& filename, int flags, const String& vfs) {
+    bool godot_path = vfs.is_empty() && SQLite3GodotVFS::is_godot_path(filename);
     sqlite3* db;
-    int rc = sqlite3_open_v2(filename.utf8().get_data(), &db, flags, vfs.is_empty() ? nullptr : vfs.utf8().get_data());
+    int rc = sqlite3_open_v2(filename.utf8().get_data(), &db, flags,
+                             godot_path ? SQLite3GodotVFS::NAME : (vfs.is_empty() ? nullptr : vfs.utf8().get_data()));
     if (rc != SQLITE_OK) {
         UtilityFunctions::printerr("Failed to open database: ", String(sqlite3_errmsg(db)));
         sqlite3_close(db);
         return Ref<SQLite3Database>();
     }
-    return Ref<SQLite3Database>(memnew(SQLite3Database(db)));
+    Ref<SQLite3Database> result = Ref<SQLite3Database>(memnew(SQLite3Database(db)));
+    result->_on_open();
+    if (godot_path && filename.begins_with("res://")) {
+        // Preloaded resources are served through xFetch, which SQLite only uses with mmap enabled
+        sqlite3_exec(db, "PRAGMA mmap_size=268435456", nullptr, nullptr, nullptr);
+    }
+    return result;
+}
+
+void SQLite3Database::_on_open() {
+    // Only connections owned by this wrapper get the hooks (db_handle() wrappers share the handle)
+    sqlite3_set_authorizer(_db, stmt_cache_authorizer_callback, this);
+    {
+        std::lock_guard<std::mutex> lock(open_databases_mutex);
+        open_databases.insert(this);
+    }
+    if (sqlite3_gd_prof::events_enabled()) _update_trace();
+}
+
+void SQLite3Database::_close_sessions() {
+    for (SQLite3Session* session : _sessions) {
+        session->_detach();
+    }
+    _sessions.clear();
+}
+
+void SQLite3Database::_remove_session(SQLite3Session* session) {
+    _sessions.erase(session);
+}
+
+void SQLite3Database::_track_task(SQLite3Task* task, bool pending) {
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    if (pending) {
+        _async_tasks.insert(task);
+    } else {
+        _async_tasks.erase(task);
+    }
+}
+
+void SQLite3Database::_track_backup(SQLite3Backup* backup, bool pending) {
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    if (pending) {
+        _async_backups.insert(backup);
+    } else {
+        _async_backups.erase(backup);
+    }
+}
+
+void SQLite3Database::_wait_async_tasks() {
+    // Tasks hold a reference to this object but not to the handle, so they
+    // must be done with it before it is closed. They stay alive until their
+    // completion is delivered on the main thread.
+    std::vector<Ref<SQLite3Task>> tasks;
+    std::vector<Ref<SQLite3Backup>> backups;
+    {
+        std::lock_guard<std::mutex> lock(_async_mutex);
+        for (SQLite3Task* task : _async_tasks) {
+            tasks.push_back(Ref<SQLite3Task>(task));
+        }
+        for (SQLite3Backup* backup : _async_backups) {
+            backups.push_back(Ref<SQLite3Backup>(backup));
+        }
+    }
+    for (Ref<SQLite3Task>& task : tasks) {
+        task->cancel();
+    }
+    for (Ref<SQLite3Backup>& backup : backups) {
+        backup->cancel();
+    }
+    for (Ref<SQLite3Task>& task : tasks) {
+        task->_join();
+    }
+    for (Ref<SQLite3Backup>& backup : backups) {
+        backup->_join();
+    }
 }
 
 int SQLite3Database::close() {
     if (!_db) return SQLITE_OK;
+    _wait_async_tasks();
+    unregister_monitors();
+    stop_capture();
+    clear_statement_cache();
+    _close_sessions();
     int rc = sqlite3_close(_db);
-    if (rc == SQLITE_OK) _db = nullptr;
+    if (rc == SQLITE_OK) {
+        forget_database(this);
+        _db = nullptr;
+    }
     return rc;
 }
 
 int SQLite3Database::close_v2() {
     if (!_db) return SQLITE_OK;
+    _wait_async_tasks();
+    unregister_monitors();
+    stop_capture();
+    clear_statement_cache();
+    _close_sessions();
+    forget_database(this);
     int rc = sqlite3_close_v2(_db);
     _db = nullptr;
     return rc;
@@ -101,6 +558,7 @@ int SQLite3Database::close_v2() {
 
 int SQLite3Database::exec(const String& sql) {
     if (!_db) return SQLITE_MISUSE;
+    _apply_deferred_trace();
     char* errmsg;
     int rc = sqlite3_exec(_db, sql.utf8().get_data(), nullptr, nullptr, &errmsg);
     if (errmsg) {
@@ -178,8 +636,97 @@ int SQLite3Database::setlk_timeout(int ms, int flags) {
     return _db ? sqlite3_setlk_timeout(_db, ms, flags) : SQLITE_MISUSE;
 }
 
+Ref<SQLite3Statement> SQLite3Database::_prepare_cached(const String& sql, unsigned int prepFlags, const char* error_prefix) {
+    std::lock_guard<std::recursive_mutex> lock(_stmt_cache_mutex);
+    if (_stmt_cache_stale) {
+        clear_statement_cache();
+    }
+    Ref<SQLite3Statement>* entry = _stmt_cache.getptr(sql);
+    if (entry) {
+        // The statement leaves the cache until it is finalized again
+        Ref<SQLite3Statement> stmt = *entry;
+        _stmt_cache.erase(sql);
+        // A script may still hold it after finalize(), such a statement is left to the script
+        if (stmt->get_stmt() && stmt->get_reference_count() == 1) {
+            _stmt_cache_hits++;
+            return stmt;
+        }
+    }
+    _stmt_cache_misses++;
+
+    sqlite3_stmt* stmt;
+    CharString utf8 = sql.utf8();
+    // Passing the length including the terminator lets SQLite skip its own scan and copy
+    int rc = sqlite3_prepare_v3(_db, utf8.get_data(), utf8.length() + 1, prepFlags | SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr(error_prefix, errmsg());
+        return Ref<SQLite3Statement>();
+    }
+    Ref<SQLite3Statement> result = Ref<SQLite3Statement>(memnew(SQLite3Statement(stmt)));
+    if (stmt) {
+        result->set_cache_owner(get_instance_id(), sql);
+    }
+    return result;
+}
+
+bool SQLite3Database::_return_to_cache(const Ref<SQLite3Statement>& stmt, const String& sql) {
+    std::lock_guard<std::recursive_mutex> lock(_stmt_cache_mutex);
+    // Statements of a closed handle, or compiled before a schema change, are finalized instead
+    if (!_db || sqlite3_db_handle(stmt->get_stmt()) != _db || _stmt_cache_stale || _stmt_cache_capacity <= 0) {
+        return false;
+    }
+    // Another statement for the same SQL was in use at the same time and came back first
+    if (_stmt_cache.has(sql)) {
+        return false;
+    }
+    _stmt_cache.insert(sql, stmt);
+    _trim_statement_cache(_stmt_cache_capacity);
+    return true;
+}
+
+void SQLite3Database::_trim_statement_cache(int capacity) {
+    while ((int)_stmt_cache.size() > capacity) {
+        // Iteration follows insertion order, so the first entry is the least recently used one
+        HashMap<String, Ref<SQLite3Statement>>::Iterator oldest = _stmt_cache.begin();
+        String key = oldest->key;
+        _stmt_cache.erase(key);
+        _stmt_cache_evictions++;
+    }
+}
+
+void SQLite3Database::set_statement_cache_size(int size) {
+    std::lock_guard<std::recursive_mutex> lock(_stmt_cache_mutex);
+    _stmt_cache_capacity = size < 0 ? 0 : size;
+    _trim_statement_cache(_stmt_cache_capacity);
+}
+
+int SQLite3Database::get_statement_cache_size() {
+    return _stmt_cache_capacity;
+}
+
+void SQLite3Database::clear_statement_cache() {
+    std::lock_guard<std::recursive_mutex> lock(_stmt_cache_mutex);
+    _stmt_cache.clear();
+    _stmt_cache_stale = false;
+}
+
+Dictionary SQLite3Database::statement_cache_stats() {
+    std::lock_guard<std::recursive_mutex> lock(_stmt_cache_mutex);
+    Dictionary stats;
+    stats["size"] = (int64_t)_stmt_cache.size();
+    stats["capacity"] = _stmt_cache_capacity.load();
+    stats["hits"] = _stmt_cache_hits;
+    stats["misses"] = _stmt_cache_misses;
+    stats["evictions"] = _stmt_cache_evictions;
+    return stats;
+}
+
 Ref<SQLite3Statement> SQLite3Database::prepare(const String& sql, int nByte) {
     if (!_db) return Ref<SQLite3Statement>();
+    _apply_deferred_trace();
+    if (nByte < 0 && _stmt_cache_capacity > 0) {
+        return _prepare_cached(sql, 0, "Prepare error: ");
+    }
     sqlite3_stmt* stmt;
     const char* tail;
     int rc = sqlite3_prepare(_db, sql.utf8().get_data(), nByte, &stmt, &tail);
@@ -192,6 +739,10 @@ Ref<SQLite3Statement> SQLite3Database::prepare(const String& sql, int nByte) {
 
 Ref<SQLite3Statement> SQLite3Database::prepare_v2(const String& sql, int nByte) {
     if (!_db) return Ref<SQLite3Statement>();
+    _apply_deferred_trace();
+    if (nByte < 0 && _stmt_cache_capacity > 0) {
+        return _prepare_cached(sql, 0, "Prepare v2 error: ");
+    }
     sqlite3_stmt* stmt;
     const char* tail;
     int rc = sqlite3_prepare_v2(_db, sql.utf8().get_data(), nByte, &stmt, &tail);
@@ -204,6 +755,11 @@ Ref<SQLite3Statement> SQLite3Database::prepare_v2(const String& sql, int nByte)
 
 Ref<SQLite3Statement> SQLite3Database::prepare_v3(const String& sql, int nByte, unsigned int prepFlags) {
     if (!_db) return Ref<SQLite3Statement>();
+    _apply_deferred_trace();
+    // Other flags change how the statement behaves, so only plain (or persistent) statements are shared
+    if (nByte < 0 && _stmt_cache_capacity > 0 && (prepFlags & ~SQLITE_PREPARE_PERSISTENT) == 0) {
+        return _prepare_cached(sql, prepFlags, "Prepare v3 error: ");
+    }
     sqlite3_stmt* stmt;
     const char* tail;
     int rc = sqlite3_prepare_v3(_db, sql.utf8().get_data(), nByte, prepFlags, &stmt, &tail);
@@ -214,6 +770,238 @@ Ref<SQLite3Statement> SQLite3Database::prepare_v3(const String& sql, int nByte,
     return Ref<SQLite3Statement>(memnew(SQLite3Statement(stmt)));
 }
 
+// Runs a prepared statement once per row inside a savepoint. bind_row(stmt, row) binds one row and
+// returns an SQLite result code. Returns {rc, changes, rows, errors} where errors lists {row, rc, message}.
+template <typename BindRow>
+static Dictionary run_batch(sqlite3* db, sqlite3_stmt* stmt, int64_t row_count, bool atomic, BindRow bind_row) {
+    Dictionary result;
+    Array errors;
+    int64_t changes = 0;
+    int64_t rows_done = 0;
+    bool aborted = false;
+    int rc = sqlite3_exec(db, "SAVEPOINT sqlite3_gd_batch", nullptr, nullptr, nullptr);
+    if (rc == SQLITE_OK) {
+        for (int64_t row = 0; row < row_count; ++row) {
+            sqlite3_reset(stmt);
+            sqlite3_gd_workload::clear_bindings(stmt);
+            int row_rc = bind_row(stmt, row);
+            if (row_rc == SQLITE_OK) {
+                do {
+                    row_rc = sqlite3_step(stmt);
+                } while (row_rc == SQLITE_ROW);
+            }
+            if (row_rc == SQLITE_DONE) {
+                changes += sqlite3_changes64(db);
+                rows_done++;
+                continue;
+            }
+            Dictionary error;
+            error["row"] = row;
+            error["rc"] = row_rc;
+            error["message"] = String(sqlite3_errmsg(db));
+            errors.append(error);
+            // Some errors (ON CONFLICT ROLLBACK, IOERR, FULL...) roll back the whole transaction,
+            // savepoint included: nothing is left to continue or to roll back to
+            if (sqlite3_get_autocommit(db)) {
+                rc = row_rc;
+                aborted = true;
+                break;
+            }
+            if (atomic) {
+                rc = row_rc;
+                break;
+            }
+        }
+        sqlite3_reset(stmt);
+        sqlite3_gd_workload::clear_bindings(stmt);
+        if (rc != SQLITE_OK) {
+            if (!aborted) sqlite3_exec(db, "ROLLBACK TO sqlite3_gd_batch", nullptr, nullptr, nullptr);
+            changes = 0;
+            rows_done = 0;
+        }
+        if (!aborted) {
+            int release_rc = sqlite3_exec(db, "RELEASE sqlite3_gd_batch", nullptr, nullptr, nullptr);
+            if (rc == SQLITE_OK) rc = release_rc;
+        }
+    } else {
+        UtilityFunctions::printerr("Batch savepoint error: ", String(sqlite3_errmsg(db)));
+    }
+    result["rc"] = rc;
+    result["changes"] = changes;
+    result["rows"] = rows_done;
+    result["errors"] = errors;
+    return result;
+}
+
+// True when sql holds more than the statement compiled from it, besides comments and semicolons
+static bool batch_has_tail(sqlite3* db, sqlite3_stmt* stmt, const String& sql) {
+    CharString utf8 = sql.utf8();
+    // sqlite3_sql() is the text the statement was compiled from, up to its tail
+    const char* compiled = sqlite3_sql(stmt);
+    size_t used = compiled ? strlen(compiled) : 0;
+    if (used >= (size_t)utf8.length()) return false;
+    sqlite3_stmt* next = nullptr;
+    int rc = sqlite3_prepare_v2(db, utf8.get_data() + used, -1, &next, nullptr);
+    sqlite3_finalize(next);
+    return rc != SQLITE_OK || next != nullptr;
+}
+
+static Dictionary batch_error(int rc) {
+    Dictionary result;
+    result["rc"] = rc;
+    result["changes"] = (int64_t)0;
+    result["rows"] = (int64_t)0;
+    result["errors"] = Array();
+    return result;
+}
+
+Dictionary SQLite3Database::execute_batch(const String& sql, const Array& rows, bool atomic) {
+    if (!_db) return batch_error(SQLITE_MISUSE);
+    Ref<SQLite3Statement> stmt = _prepare_cached(sql, 0, "Batch prepare error: ");
+    if (stmt.is_null() || !stmt->get_stmt()) return batch_error(stmt.is_null() ? errcode() : SQLITE_MISUSE);
+    if (batch_has_tail(_db, stmt->get_stmt(), sql)) {
+        UtilityFunctions::printerr("Batch error: the SQL must hold a single statement");
+        stmt->finalize();
+        return batch_error(SQLITE_MISUSE);
+    }
+    Dictionary result = run_batch(_db, stmt->get_stmt(), rows.size(), atomic, [&rows](sqlite3_stmt* raw, int64_t row) {
+        const Variant& values = rows[row];
+        if (values.get_type() != Variant::Type::ARRAY) return SQLITE_MISMATCH;
+        Array params = values;
+        for (int64_t i = 0; i < params.size(); ++i) {
+            int rc = SQLite3Statement::bind_variant(raw, (int)i + 1, params[i]);
+            if (rc != SQLITE_OK) return rc;
+        }
+        return SQLITE_OK;
+    });
+    stmt->finalize();
+    return result;
+}
+
+// One bindable column of execute_batch_columns(), the packed arrays keep their buffers alive
+struct BatchColumn {
+    Variant::Type type;
+    PackedInt32Array int32s;
+    PackedInt64Array int64s;
+    PackedFloat32Array float32s;
+    PackedFloat64Array float64s;
+    PackedStringArray strings;
+    Array values;
+    int64_t size;
+};
+
+Dictionary SQLite3Database::execute_batch_columns(const String& sql, const Array& columns, bool atomic) {
+    if (!_db) return batch_error(SQLITE_MISUSE);
+    std::vector<BatchColumn> sources(columns.size());
+    int64_t row_count = -1;
+    for (int64_t i = 0; i < columns.size(); ++i) {
+        BatchColumn& column = sources[i];
+        const Variant& value = columns[i];
+        column.type = value.get_type();
+        switch (column.type) {
+            case Variant::Type::PACKED_INT32_ARRAY:
+                column.int32s = value;
+                column.size = column.int32s.size();
+                break;
+            case Variant::Type::PACKED_INT64_ARRAY:
+                column.int64s = value;
+                column.size = column.int64s.size();
+                break;
+            case Variant::Type::PACKED_FLOAT32_ARRAY:
+                column.float32s = value;
+                column.size = column.float32s.size();
+                break;
+            case Variant::Type::PACKED_FLOAT64_ARRAY:
+                column.float64s = value;
+                column.size = column.float64s.size();
+                break;
+            case Variant::Type::PACKED_STRING_ARRAY:
+                column.strings = value;
+                column.size = column.strings.size();
+                break;
+            case Variant::Type::ARRAY:
+                column.values = value;
+                column.size = column.values.size();
+                break;
+            default:
+                UtilityFunctions::printerr("Batch column ", i, " has unsupported type ", Variant::get_type_name(column.type));
+                return batch_error(SQLITE_MISMATCH);
+        }
+        if (row_count >= 0 && column.size != row_count) {
+            UtilityFunctions::printerr("Batch columns must all have the same length");
+            return batch_error(SQLITE_MISUSE);
+        }
+        row_count = column.size;
+    }
+    Ref<SQLite3Statement> stmt = _prepare_cached(sql, 0, "Batch prepare error: ");
+    if (stmt.is_null() || !stmt->get_stmt()) return batch_error(stmt.is_null() ? errcode() : SQLITE_MISUSE);
+    if (batch_has_tail(_db, stmt->get_stmt(), sql)) {
+        UtilityFunctions::printerr("Batch error: the SQL must hold a single statement");
+        stmt->finalize();
+        return batch_error(SQLITE_MISUSE);
+    }
+    Dictionary result = run_batch(_db, stmt->get_stmt(), row_count < 0 ? 0 : row_count, atomic, [&sources](sqlite3_stmt* raw, int64_t row) {
+        for (size_t i = 0; i < sources.size(); ++i) {
+            const BatchColumn& column = sources[i];
+            int index = (int)i + 1;
+            int rc;
+            switch (column.type) {
+                case Variant::Type::PACKED_INT32_ARRAY:
+                    rc = sqlite3_gd_workload::bind_int(raw, index, column.int32s[row]);
+                    break;
+                case Variant::Type::PACKED_INT64_ARRAY:
+                    rc = sqlite3_gd_workload::bind_int64(raw, index, column.int64s[row]);
+                    break;
+                case Variant::Type::PACKED_FLOAT32_ARRAY:
+                    rc = sqlite3_gd_workload::bind_double(raw, index, column.float32s[row]);
+                    break;
+                case Variant::Type::PACKED_FLOAT64_ARRAY:
+                    rc = sqlite3_gd_workload::bind_double(raw, index, column.float64s[row]);
+                    break;
+                case Variant::Type::PACKED_STRING_ARRAY: {
+                    CharString utf8 = column.strings[row].utf8();
+                    rc = sqlite3_gd_workload::bind_text(raw, index, utf8.get_data(), utf8.length(), SQLITE_TRANSIENT);
+                    break;
+                }
+                default:
+                    rc = SQLite3Statement::bind_variant(raw, index, column.values[row]);
+                    break;
+            }
+            if (rc != SQLITE_OK) return rc;
+        }
+        return SQLITE_OK;
+    });
+    stmt->finalize();
+    return result;
+}
+
+Ref<SQLite3Task> SQLite3Database::exec_async(const String& sql) {
+    if (!_db) return Ref<SQLite3Task>();
+    Ref<SQLite3Task> task = Ref<SQLite3Task>(memnew(SQLite3Task));
+    task->start(Ref<SQLite3Database>(this), SQLite3Task::KIND_EXEC, sql, Array());
+    return task;
+}
+
+Ref<SQLite3Task> SQLite3Database::query_async(const String& sql, const Array& params) {
+    if (!_db) return Ref<SQLite3Task>();
+    Ref<SQLite3Task> task = Ref<SQLite3Task>(memnew(SQLite3Task));
+    task->start(Ref<SQLite3Database>(this), SQLite3Task::KIND_QUERY, sql, params);
+    return task;
+}
+
+Ref<SQLite3Task> SQLite3Database::blob_import_async(const String& path, const String& zTable, const String& zColumn,
+                                                    int64_t iRow, const String& zDb) {
+    if (!_db) return Ref<SQLite3Task>();
+    Ref<SQLite3Task> task = Ref<SQLite3Task>(memnew(SQLite3Task));
+    Array target;
+    target.append(zDb);
+    target.append(zTable);
+    target.append(zColumn);
+    target.append(iRow);
+    task->start(Ref<SQLite3Database>(this), SQLite3Task::KIND_BLOB_IMPORT, path, target);
+    return task;
+}
+
 Array SQLite3Database::get_table(const String& sql) {
     if (!_db) return Array();
     char** result;
@@ -239,6 +1027,12 @@ Array SQLite3Database::get_table(const String& sql) {
 
 Ref<SQLite3ResultSet> SQLite3Database::query(const String& sql) {
     if (!_db) return Ref<SQLite3ResultSet>();
+    _apply_deferred_trace();
+    if (_stmt_cache_capacity > 0) {
+        Ref<SQLite3Statement> cached = _prepare_cached(sql, 0, "Prepare error: ");
+        if (cached.is_null()) return Ref<SQLite3ResultSet>();
+        return Ref<SQLite3ResultSet>(memnew(SQLite3ResultSet(cached)));
+    }
     sqlite3_stmt* stmt;
     const char* tail;
     int rc = sqlite3_prepare_v2(_db, sql.utf8().get_data(), -1, &stmt, &tail);
@@ -256,7 +1050,7 @@ Ref<SQLite3Backup> SQLite3Database::backup_init(const String& zDestName, Ref<SQL
         UtilityFunctions::printerr("Backup init error");
         return Ref<SQLite3Backup>();
     }
-    return Ref<SQLite3Backup>(memnew(SQLite3Backup(backup)));
+    return Ref<SQLite3Backup>(memnew(SQLite3Backup(backup, Ref<SQLite3Database>(this), destDb)));
 }
 
 int SQLite3Database::db_config(int op, Variant args) {
@@ -296,6 +1090,311 @@ Ref<SQLite3Statement> SQLite3Database::next_stmt(Ref<SQLite3Statement> pStmt) {
     return stmt ? Ref<SQLite3Statement>(memnew(SQLite3Statement(stmt))) : Ref<SQLite3Statement>();
 }
 
+void SQLite3Database::_update_progress_handler() {
+    int period = 0;
+    if (_query_deadline_usec > 0) period = DEADLINE_CHECK_OPS;
+    if (_progress_handler.is_valid()) period = period > 0 ? std::min(period, _progress_ops) : _progress_ops;
+    _progress_period = period;
+    _progress_ops_pending = 0;
+    sqlite3_progress_handler(_db, period, period > 0 ? progress_handler_callback : nullptr, this);
+}
+
+void SQLite3Database::_update_trace() {
+    unsigned int mask = 0;
+    if (_query_deadline_usec > 0) mask |= SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE;
+    if (_profiling) mask |= SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE;
+    if (_monitoring) mask |= SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE;
+    if (_recorder) mask |= SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE;
+    if (sqlite3_gd_prof::events_enabled()) mask |= SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE;
+    sqlite3_trace_v2(_db, mask, mask ? trace_callback : nullptr, this);
+    if (mask == 0) {
+        // Trace callbacks may still be running on other threads, they hold the connection mutex
+        sqlite3_mutex_enter(sqlite3_db_mutex(_db));
+        _running_stmts.clear();
+        sqlite3_mutex_leave(sqlite3_db_mutex(_db));
+        _stmt_running = nullptr;
+    }
+}
+
+int SQLite3Database::progress_handler(int n_ops, Callable handler) {
+    if (!_db) return SQLITE_MISUSE;
+    if (handler.is_valid() && n_ops < 1) return SQLITE_RANGE;
+    _progress_handler = handler;
+    _progress_ops = handler.is_valid() ? n_ops : 0;
+    _update_progress_handler();
+    return SQLITE_OK;
+}
+
+void SQLite3Database::set_query_deadline(int64_t usec) {
+    if (!_db) return;
+    usec = std::max(usec, (int64_t)0);
+    {
+        std::lock_guard<std::mutex> lock(open_databases_mutex);  // Pairs with forget_database()
+        if ((_query_deadline_usec > 0) != (usec > 0)) deadline_databases += usec > 0 ? 1 : -1;
+        _query_deadline_usec = usec;
+    }
+    _update_trace();
+    _update_progress_handler();
+}
+
+int64_t SQLite3Database::get_query_deadline() {
+    return _query_deadline_usec;
+}
+
+Dictionary SQLite3Database::get_last_interrupt() {
+    return _last_interrupt;
+}
+
+void SQLite3Database::enable_profiling(bool enable) {
+    if (!_db) return;
+    if (enable && !_profiler) _profiler.reset(new sqlite3_gd_prof::Profiler());
+    _profiling = enable;
+    _update_trace();
+}
+
+bool SQLite3Database::is_profiling() {
+    return _profiling;
+}
+
+Dictionary SQLite3Database::get_profile() {
+    Dictionary result;
+    if (!_profiler) return result;
+    for (const auto& entry : _profiler->snapshot()) {
+        const sqlite3_gd_prof::SqlStats& stats = entry.second;
+        Dictionary info;
+        info["calls"] = (int64_t)stats.calls;
+        info["total_usec"] = stats.total_ns / 1000.0;
+        info["mean_usec"] = stats.calls ? stats.total_ns / 1000.0 / stats.calls : 0.0;
+        info["p50_usec"] = stats.latency.percentile(0.50) / 1000.0;
+        info["p95_usec"] = stats.latency.percentile(0.95) / 1000.0;
+        info["p99_usec"] = stats.latency.percentile(0.99) / 1000.0;
+        info["max_usec"] = stats.latency.max() / 1000.0;
+        info["rows"] = (int64_t)stats.rows;
+        info["vm_steps"] = (int64_t)stats.vm_steps;
+        result[String::utf8(entry.first.c_str())] = info;
+    }
+    return result;
+}
+
+void SQLite3Database::reset_profile() {
+    if (_profiler) _profiler->reset();
+}
+
+Array SQLite3Database::peek_statement_events() {
+    std::vector<sqlite3_gd_prof::StatementEvent> pending;
+    sqlite3_gd_prof::peek_events(pending);
+    return SQLite3DebuggerProfiler::events_to_array(pending);
+}
+
+// Monitor ids, in the order of the Monitor enum
+static const char* MONITOR_NAMES[] = {
+    "heap_bytes",
+    "connection_bytes",
+    "cache_hits_per_frame",
+    "cache_misses_per_frame",
+    "cache_writes_per_frame",
+    "lookaside_slots_used",
+    "statements_per_frame",
+    "sqlite_usec_per_frame",
+    "wal_bytes",
+};
+
+int SQLite3Database::register_monitors(const String& label) {
+    if (!_db) return SQLITE_MISUSE;
+    unregister_monitors();
+    String name = label;
+    if (name.is_empty()) {
+        const char* filename = sqlite3_db_filename(_db, "main");
+        name = filename && filename[0] ? String::utf8(filename).get_file() : String("memory");
+    }
+    _monitor_category = "SQLite3 " + name;
+    uint64_t frame = Engine::get_singleton()->get_process_frames();
+    for (int i = 0; i < MONITOR_MAX; ++i) {
+        _monitor_rates[i] = MonitorRate();
+        _monitor_rates[i].last_frame = frame;
+    }
+    _monitoring = true;
+    _update_trace();
+    for (int i = 0; i < MONITOR_MAX; ++i) {
+        _monitor_rates[i].last_counter = _monitor_counter(i);
+    }
+
+    Performance* performance = Performance::get_singleton();
+    for (int i = 0; i < MONITOR_MAX; ++i) {
+        Array args;
+        args.append(i);
+        performance->add_custom_monitor(_monitor_category + "/" + MONITOR_NAMES[i],
+                                        callable_mp(this, &SQLite3Database::_sample_monitor), args);
+    }
+    return SQLITE_OK;
+}
+
+void SQLite3Database::unregister_monitors() {
+    if (_monitor_category.is_empty()) return;
+    Performance* performance = Performance::get_singleton();
+    for (int i = 0; i < MONITOR_MAX; ++i) {
+        StringName id = _monitor_category + "/" + MONITOR_NAMES[i];
+        if (performance->has_custom_monitor(id)) performance->remove_custom_monitor(id);
+    }
+    _monitor_category = String();
+    _monitoring = false;
+    if (_db) _update_trace();
+}
+
+double SQLite3Database::_per_frame(int monitor, uint64_t counter) {
+    // The engine samples monitors at its own rate, so average over the frames since the last sample
+    MonitorRate& rate = _monitor_rates[monitor];
+    uint64_t frame = Engine::get_singleton()->get_process_frames();
+    if (frame > rate.last_frame) {
+        rate.per_frame = (double)(counter - std::min(counter, rate.last_counter)) / (frame - rate.last_frame);
+        rate.last_frame = frame;
+        rate.last_counter = counter;
+    }
+    return rate.per_frame;
+}
+
+int64_t SQLite3Database::_wal_bytes() {
+    int64_t size = 0;
+    sqlite3_mutex_enter(sqlite3_db_mutex(_db));
+    sqlite3_file* wal = nullptr;
+    // The journal pointer is the WAL file while the database is in WAL mode
+    if (sqlite3_file_control(_db, "main", SQLITE_FCNTL_JOURNAL_POINTER, &wal) == SQLITE_OK && wal && wal->pMethods) {
+        sqlite3_int64 wal_size = 0;
+        if (wal->pMethods->xFileSize(wal, &wal_size) == SQLITE_OK) size = wal_size;
+    }
+    sqlite3_mutex_leave(sqlite3_db_mutex(_db));
+    return size;
+}
+
+uint64_t SQLite3Database::_monitor_counter(int monitor) {
+    int op;
+    switch (monitor) {
+        case MONITOR_CACHE_HITS: op = SQLITE_DBSTATUS_CACHE_HIT; break;
+        case MONITOR_CACHE_MISSES: op = SQLITE_DBSTATUS_CACHE_MISS; break;
+        case MONITOR_CACHE_WRITES: op = SQLITE_DBSTATUS_CACHE_WRITE; break;
+        case MONITOR_STATEMENTS: return _statements_run.load(std::memory_order_relaxed);
+        case MONITOR_SQLITE_USEC: return _statements_ns.load(std::memory_order_relaxed) / 1000;
+        default: return 0;
+    }
+    int current = 0;
+    int highwater = 0;
+    sqlite3_db_status(_db, op, &current, &highwater, 0);
+    return (uint32_t)current;
+}
+
+double SQLite3Database::_sample_monitor(int monitor) {
+    if (!_db) return 0.0;
+    int current = 0;
+    int highwater = 0;
+    switch (monitor) {
+        case MONITOR_HEAP_BYTES:
+            return (double)sqlite3_memory_used();
+        case MONITOR_CONNECTION_BYTES: {
+            int64_t total = 0;
+            for (int op : {SQLITE_DBSTATUS_CACHE_USED, SQLITE_DBSTATUS_SCHEMA_USED, SQLITE_DBSTATUS_STMT_USED}) {
+                sqlite3_db_status(_db, op, &current, &highwater, 0);
+                total += current;
+            }
+            return (double)total;
+        }
+        case MONITOR_LOOKASIDE_USED:
+            sqlite3_db_status(_db, SQLITE_DBSTATUS_LOOKASIDE_USED, &current, &highwater, 0);
+            return (double)current;
+        case MONITOR_WAL_BYTES:
+            return (double)_wal_bytes();
+        default:
+            // Counters are reported as the average per frame since the last sample
+            return _per_frame(monitor, _monitor_counter(monitor));
+    }
+}
+
+int SQLite3Database::start_capture(const String& path) {
+    if (!_db) return SQLITE_MISUSE;
+    stop_capture();
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+    if (file.is_null()) {
+        UtilityFunctions::printerr("Capture error: cannot open ", path);
+        return SQLITE_CANTOPEN;
+    }
+    // The file is closed when the last reference to the recorder goes away
+    std::shared_ptr<sqlite3_gd_workload::Recorder> recorder = std::make_shared<sqlite3_gd_workload::Recorder>(
+        [file](const uint8_t* data, size_t size) { file->store_buffer(data, size); });
+    sqlite3_gd_workload::attach(_db, recorder);
+    sqlite3_mutex_enter(sqlite3_db_mutex(_db));
+    _recorder = recorder;
+    sqlite3_mutex_leave(sqlite3_db_mutex(_db));
+    _capture_start_usec = Time::get_singleton()->get_ticks_usec();
+    _update_trace();
+    return SQLITE_OK;
+}
+
+Dictionary SQLite3Database::stop_capture() {
+    Dictionary result;
+    if (!_db || !_recorder) return result;
+    sqlite3_gd_workload::detach(_db);
+    std::shared_ptr<sqlite3_gd_workload::Recorder> recorder;
+    // Trace callbacks may be running on other threads, they hold the connection mutex
+    sqlite3_mutex_enter(sqlite3_db_mutex(_db));
+    recorder.swap(_recorder);
+    sqlite3_mutex_leave(sqlite3_db_mutex(_db));
+    _update_trace();
+    recorder->finish();
+    result["executions"] = (int64_t)recorder->executions();
+    result["statements"] = (int64_t)recorder->statements();
+    result["bytes"] = (int64_t)recorder->bytes_written();
+    result["usec"] = (int64_t)(Time::get_singleton()->get_ticks_usec() - _capture_start_usec);
+    return result;
+}
+
+bool SQLite3Database::is_capturing() {
+    return _recorder != nullptr;
+}
+
+static void put_replay_stats(Dictionary& info, const sqlite3_gd_workload::ReplayStats& stats) {
+    info["executions"] = (int64_t)stats.executions;
+    info["errors"] = (int64_t)stats.errors;
+    info["rows"] = (int64_t)stats.rows;
+    info["total_usec"] = stats.total_ns / 1000.0;
+    info["p50_usec"] = stats.latency.percentile(0.50) / 1000.0;
+    info["p95_usec"] = stats.latency.percentile(0.95) / 1000.0;
+    info["p99_usec"] = stats.latency.percentile(0.99) / 1000.0;
+    info["max_usec"] = stats.latency.max() / 1000.0;
+    info["recorded_p50_usec"] = stats.recorded.percentile(0.50) / 1000.0;
+    info["recorded_p95_usec"] = stats.recorded.percentile(0.95) / 1000.0;
+    info["recorded_p99_usec"] = stats.recorded.percentile(0.99) / 1000.0;
+    info["recorded_max_usec"] = stats.recorded.max() / 1000.0;
+}
+
+Dictionary SQLite3Database::replay_workload(const String& path, double speed) {
+    Dictionary result;
+    result["rc"] = SQLITE_MISUSE;
+    if (!_db) return result;
+    if (!FileAccess::file_exists(path)) {
+        UtilityFunctions::printerr("Replay error: cannot open ", path);
+        result["rc"] = SQLITE_CANTOPEN;
+        return result;
+    }
+    PackedByteArray trace = FileAccess::get_file_as_bytes(path);
+    sqlite3_gd_workload::ReplayReport report =
+        sqlite3_gd_workload::replay(_db, trace.ptr(), trace.size(), std::max(speed, 0.0));
+    if (report.rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Replay error: ", String::utf8(report.first_error.c_str()));
+    }
+
+    put_replay_stats(result, report.total);
+    Dictionary statements;
+    for (const auto& entry : report.per_sql) {
+        Dictionary info;
+        put_replay_stats(info, entry.second);
+        statements[String::utf8(entry.first.c_str())] = info;
+    }
+    result["rc"] = report.rc;
+    result["wall_usec"] = (int64_t)(report.wall_ns / 1000);
+    result["first_error"] = String::utf8(report.first_error.c_str());
+    result["statements"] = statements;
+    return result;
+}
+
 int SQLite3Database::busy_handler(Callable handler) {
     _busy_handler = handler;
     return sqlite3_busy_handler(_db, handler.is_valid() ? busy_handler_callback : nullptr, this);
@@ -316,6 +1415,11 @@ void SQLite3Database::update_hook(Callable hook) {
     sqlite3_update_hook(_db, hook.is_valid() ? update_hook_callback : nullptr, this);
 }
 
+void SQLite3Database::set_authorizer(Callable authorizer) {
+    // The callback installed at open stays, it also keeps the statement cache in step with the schema
+    _authorizer = authorizer;
+}
+
 int SQLite3Database::autovacuum_pages(Callable callback) {
     _autovacuum_callback = callback;
     return sqlite3_autovacuum_pages(_db, callback.is_valid() ? autovacuum_pages_callback : nullptr, this, nullptr);
@@ -344,14 +1448,213 @@ void SQLite3Database::reset_auto_extension() {
 }
 
 int SQLite3Database::create_module(const String& zName, Variant pModule) {
-    // Simplified
-    return SQLITE_MISUSE;
+    if (!_db) return SQLITE_MISUSE;
+    int rc = sqlite3_gd_create_array_module(_db, zName.utf8().get_data(), pModule);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Create module error: ", String(sqlite3_errstr(rc)));
+    }
+    return rc;
 }
 
 int SQLite3Database::declare_vtab(const String& zSQL) {
     return _db ? sqlite3_declare_vtab(_db, zSQL.utf8().get_data()) : SQLITE_MISUSE;
 }
 
+int SQLite3Database::_create_user_function(const String& name, int n_args, int flags, UserFunction* fn,
+                                           bool aggregate, bool window) {
+    if (!_db) {
+        memdelete(fn);
+        return SQLITE_MISUSE;
+    }
+    // Only the function property flags are accepted, the text encoding is always UTF-8
+    int eTextRep = SQLITE_UTF8 | (flags & (SQLITE_DETERMINISTIC | SQLITE_DIRECTONLY | SQLITE_INNOCUOUS));
+    int rc;
+    if (window) {
+        rc = sqlite3_create_window_function(_db, name.utf8().get_data(), n_args, eTextRep, fn, user_function_step,
+                                            user_function_final, user_function_value, user_function_inverse,
+                                            user_function_destroy);
+    } else if (aggregate) {
+        rc = sqlite3_create_function_v2(_db, name.utf8().get_data(), n_args, eTextRep, fn, nullptr, user_function_step,
+                                        user_function_final, user_function_destroy);
+    } else {
+        rc = sqlite3_create_function_v2(_db, name.utf8().get_data(), n_args, eTextRep, fn, user_function_scalar,
+                                        nullptr, nullptr, user_function_destroy);
+    }
+    if (rc != SQLITE_OK) {
+        // SQLite already called xDestroy on failure
+        UtilityFunctions::printerr("Create function error: ", errmsg());
+    }
+    return rc;
+}
+
+int SQLite3Database::create_function(const String& name, int n_args, Callable func, int flags) {
+    if (!func.is_valid()) return SQLITE_MISUSE;
+    UserFunction* fn = memnew(UserFunction);
+    fn->func = func;
+    return _create_user_function(name, n_args, flags, fn, false, false);
+}
+
+int SQLite3Database::create_aggregate(const String& name, int n_args, Callable step, Callable final, int flags,
+                                      const Variant& initial) {
+    if (!step.is_valid() || !final.is_valid()) return SQLITE_MISUSE;
+    UserFunction* fn = memnew(UserFunction);
+    fn->step = step;
+    fn->final = final;
+    fn->initial = initial;
+    return _create_user_function(name, n_args, flags, fn, true, false);
+}
+
+int SQLite3Database::create_window_function(const String& name, int n_args, Callable step, Callable inverse,
+                                            Callable value, Callable final, int flags, const Variant& initial) {
+    if (!step.is_valid() || !inverse.is_valid() || !value.is_valid() || !final.is_valid()) return SQLITE_MISUSE;
+    UserFunction* fn = memnew(UserFunction);
+    fn->step = step;
+    fn->inverse = inverse;
+    fn->value = value;
+    fn->final = final;
+    fn->initial = initial;
+    return _create_user_function(name, n_args, flags, fn, true, true);
+}
+
+int SQLite3Database::remove_function(const String& name, int n_args) {
+    if (!_db) return SQLITE_MISUSE;
+    return sqlite3_create_function_v2(_db, name.utf8().get_data(), n_args, SQLITE_UTF8, nullptr, nullptr, nullptr,
+                                      nullptr, nullptr);
+}
+
+Ref<SQLite3Session> SQLite3Database::session_create(const String& zDb) {
+    if (!_db) return Ref<SQLite3Session>();
+    sqlite3_session* session;
+    int rc = sqlite3session_create(_db, zDb.utf8().get_data(), &session);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Session create error: ", String(sqlite3_errstr(rc)));
+        return Ref<SQLite3Session>();
+    }
+    Ref<SQLite3Session> result = Ref<SQLite3Session>(memnew(SQLite3Session(session, Ref<SQLite3Database>(this))));
+    _sessions.insert(result.ptr());
+    return result;
+}
+
+int SQLite3Database::changeset_apply(const PackedByteArray& changeset, const Variant& on_conflict, Callable filter, int flags) {
+    if (!_db) return SQLITE_MISUSE;
+    ChangesetApply apply;
+    apply.on_conflict = on_conflict;
+    apply.filter = filter;
+    int rc = sqlite3changeset_apply_v2(_db, changeset.size(), const_cast<uint8_t*>(changeset.ptr()),
+                                       filter.is_valid() ? changeset_filter_callback : nullptr,
+                                       changeset_conflict_callback, &apply, nullptr, nullptr, flags);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Changeset apply error: ", errmsg());
+    }
+    return rc;
+}
+
+PackedByteArray SQLite3Database::changeset_invert(const PackedByteArray& changeset) {
+    PackedByteArray result;
+    int size = 0;
+    void* data = nullptr;
+    int rc = sqlite3changeset_invert(changeset.size(), changeset.ptr(), &size, &data);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Changeset invert error: ", String(sqlite3_errstr(rc)));
+    } else if (size > 0) {
+        result.resize(size);
+        memcpy(result.ptrw(), data, size);
+    }
+    sqlite3_free(data);
+    return result;
+}
+
+PackedByteArray SQLite3Database::changeset_concat(const PackedByteArray& a, const PackedByteArray& b) {
+    PackedByteArray result;
+    int size = 0;
+    void* data = nullptr;
+    int rc = sqlite3changeset_concat(a.size(), const_cast<uint8_t*>(a.ptr()), b.size(), const_cast<uint8_t*>(b.ptr()),
+                                     &size, &data);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Changeset concat error: ", String(sqlite3_errstr(rc)));
+    } else if (size > 0) {
+        result.resize(size);
+        memcpy(result.ptrw(), data, size);
+    }
+    sqlite3_free(data);
+    return result;
+}
+
+Array SQLite3Database::changeset_changes(const PackedByteArray& changeset) {
+    Array changes;
+    sqlite3_changeset_iter* iter;
+    if (sqlite3changeset_start(&iter, changeset.size(), const_cast<uint8_t*>(changeset.ptr())) != SQLITE_OK) {
+        return changes;
+    }
+    while (sqlite3changeset_next(iter) == SQLITE_ROW) {
+        changes.append(SQLite3Session::change_info(iter, false));
+    }
+    int rc = sqlite3changeset_finalize(iter);
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Changeset read error: ", String(sqlite3_errstr(rc)));
+    }
+    return changes;
+}
+
+int SQLite3Database::_begin_snapshot_read(const String& zSchema) {
+    String begin = "BEGIN; SELECT 1 FROM \"" + zSchema.replace("\"", "\"\"") + "\".sqlite_schema LIMIT 1";
+    int rc = sqlite3_exec(_db, begin.utf8().get_data(), nullptr, nullptr, nullptr);
+    if (rc != SQLITE_OK && !sqlite3_get_autocommit(_db)) {
+        sqlite3_exec(_db, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+    return rc;
+}
+
+Ref<SQLite3Snapshot> SQLite3Database::snapshot_get(const String& zSchema) {
+    if (!_db) return Ref<SQLite3Snapshot>();
+    // A snapshot needs an open read transaction, start a short one if there is none
+    bool own_transaction = sqlite3_get_autocommit(_db) != 0;
+    if (own_transaction && _begin_snapshot_read(zSchema) != SQLITE_OK) {
+        UtilityFunctions::printerr("Snapshot get error: ", errmsg());
+        return Ref<SQLite3Snapshot>();
+    }
+    sqlite3_snapshot* snapshot = nullptr;
+    int rc = sqlite3_snapshot_get(_db, zSchema.utf8().get_data(), &snapshot);
+    if (own_transaction) {
+        sqlite3_exec(_db, "COMMIT", nullptr, nullptr, nullptr);
+    }
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Snapshot get error: ", String(sqlite3_errstr(rc)));
+        return Ref<SQLite3Snapshot>();
+    }
+    return Ref<SQLite3Snapshot>(memnew(SQLite3Snapshot(snapshot)));
+}
+
+int SQLite3Database::snapshot_open(const Ref<SQLite3Snapshot>& snapshot, const String& zSchema) {
+    if (!_db || snapshot.is_null() || !snapshot->is_valid()) return SQLITE_MISUSE;
+    // The snapshot must be opened inside a transaction. SQLite restarts an idle read
+    // transaction at the snapshot, so reading first is fine and makes a fresh connection
+    // open the WAL, without which the snapshot cannot be opened.
+    bool own_transaction = sqlite3_get_autocommit(_db) != 0;
+    if (own_transaction) {
+        int rc = _begin_snapshot_read(zSchema);
+        if (rc != SQLITE_OK) {
+            UtilityFunctions::printerr("Snapshot open error: ", errmsg());
+            return rc;
+        }
+    }
+    int rc = sqlite3_snapshot_open(_db, zSchema.utf8().get_data(), snapshot->get_snapshot());
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Snapshot open error: ", String(sqlite3_errstr(rc)));
+        if (own_transaction) sqlite3_exec(_db, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+    return rc;
+}
+
+int SQLite3Database::snapshot_recover(const String& zDb) {
+    return _db ? sqlite3_snapshot_recover(_db, zDb.utf8().get_data()) : SQLITE_MISUSE;
+}
+
+int SQLite3Database::snapshot_cmp(const Ref<SQLite3Snapshot>& a, const Ref<SQLite3Snapshot>& b) {
+    if (a.is_null() || b.is_null() || !a->is_valid() || !b->is_valid()) return 0;
+    return sqlite3_snapshot_cmp(a->get_snapshot(), b->get_snapshot());
+}
+
 int SQLite3Database::overload_function(const String& zFuncName, int nArg) {
     return _db ? sqlite3_overload_function(_db, zFuncName.utf8().get_data(), nArg) : SQLITE_MISUSE;
 }
@@ -399,7 +1702,8 @@ Array SQLite3Database::serialize(const String& zSchema, unsigned int mFlags) {
     PackedByteArray result;
     result.resize(size);
     memcpy(result.ptrw(), data, size);
-    sqlite3_free(data);
+    // With SQLITE_SERIALIZE_NOCOPY the pointer is the database's own memory
+    if (!(mFlags & SQLITE_SERIALIZE_NOCOPY)) sqlite3_free(data);
     Array arr;
     arr.append(result);
     arr.append((int64_t)size);
@@ -407,7 +1711,280 @@ Array SQLite3Database::serialize(const String& zSchema, unsigned int mFlags) {
 }
 
 int SQLite3Database::deserialize(const String& zSchema, const PackedByteArray& pData, int64_t szDb, int64_t szBuf, unsigned int mFlags) {
-    return _db ? sqlite3_deserialize(_db, zSchema.utf8().get_data(), (unsigned char*)pData.ptr(), szDb, szBuf, mFlags) : SQLITE_MISUSE;
+    if (!_db) return SQLITE_MISUSE;
+    // SQLite keeps using the buffer after this call, so it gets its own copy to free on close
+    if (szDb < 0 || szDb > pData.size()) szDb = pData.size();
+    if (szBuf < szDb) szBuf = szDb;
+    unsigned char* buffer = static_cast<unsigned char*>(sqlite3_malloc64(szBuf > 0 ? szBuf : 1));
+    if (!buffer) return SQLITE_NOMEM;
+    memcpy(buffer, pData.ptr(), szDb);
+    return sqlite3_deserialize(_db, zSchema.utf8().get_data(), buffer, szDb, szBuf, mFlags | SQLITE_DESERIALIZE_FREEONCLOSE);
+}
+
+// Compressed saves start with SAVE_MAGIC, the compression mode, the block size and the
+// database size, followed by blocks of [u32 compressed size][compressed bytes], so neither
+// side ever holds more than one block besides the database itself. Uncompressed saves are
+// plain database files.
+static const uint8_t SAVE_MAGIC[4] = {'G', 'D', 'S', 'Z'};
+static const uint32_t SAVE_BLOCK_SIZE = 1 << 20;
+static const uint32_t SAVE_HEADER_SIZE = 4 + 4 + 4 + 8;
+
+struct SaveWriter {
+    Ref<FileAccess> file;
+    int compression = -1;
+    PackedByteArray block;
+    int64_t block_used = 0;
+    bool failed = false;  // A block could not be compressed
+
+    void _flush_block() {
+        if (block_used == 0) return;
+        if (block_used < block.size()) block.resize(block_used);
+        PackedByteArray packed = block.compress(compression);
+        if (packed.is_empty()) {
+            // Nothing sensible can follow in the stream, the save is abandoned
+            failed = true;
+            block_used = 0;
+            return;
+        }
+        file->store_32((uint32_t)packed.size());
+        file->store_buffer(packed.ptr(), packed.size());
+        block.resize(SAVE_BLOCK_SIZE);
+        block_used = 0;
+    }
+
+    void write(const uint8_t* data, int64_t size) {
+        if (compression < 0) {
+            file->store_buffer(data, size);
+            return;
+        }
+        while (size > 0) {
+            int64_t n = std::min(size, (int64_t)SAVE_BLOCK_SIZE - block_used);
+            memcpy(block.ptrw() + block_used, data, n);
+            block_used += n;
+            data += n;
+            size -= n;
+            if (block_used == SAVE_BLOCK_SIZE) _flush_block();
+        }
+    }
+
+    void begin(int64_t total) {
+        if (compression < 0) return;
+        file->store_buffer(SAVE_MAGIC, 4);
+        file->store_32((uint32_t)compression);
+        file->store_32(SAVE_BLOCK_SIZE);
+        file->store_64((uint64_t)total);
+        block.resize(SAVE_BLOCK_SIZE);
+    }
+
+    void finish() {
+        if (compression >= 0) _flush_block();
+        file->flush();
+    }
+};
+
+// Writes page 1 as a rollback-journal database: the in-memory database a save is loaded
+// into cannot use WAL
+static void save_write_first_page(SaveWriter& writer, const uint8_t* page, int64_t size) {
+    if (size > 19 && page[18] == 2 && page[19] == 2) {
+        std::vector<uint8_t> header(page, page + size);
+        header[18] = 1;
+        header[19] = 1;
+        writer.write(header.data(), size);
+    } else {
+        writer.write(page, size);
+    }
+}
+
+Dictionary SQLite3Database::save_to_file(const String& path, const String& zSchema, int compression) {
+    Dictionary result;
+    result["rc"] = SQLITE_MISUSE;
+    if (!_db) return result;
+    if (compression != -1 && (compression < FileAccess::COMPRESSION_FASTLZ || compression > FileAccess::COMPRESSION_GZIP)) {
+        UtilityFunctions::printerr("Save error: unknown compression mode ", compression);
+        return result;
+    }
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+
+    // Written beside the target and renamed over it once complete, so a failed save leaves the
+    // previous file intact
+    String temp_path = path + ".tmp";
+    SaveWriter writer;
+    writer.compression = compression;
+    writer.file = FileAccess::open(temp_path, FileAccess::WRITE);
+    if (writer.file.is_null()) {
+        UtilityFunctions::printerr("Save error: cannot open ", temp_path);
+        result["rc"] = SQLITE_CANTOPEN;
+        return result;
+    }
+    CharString schema = zSchema.utf8();
+    int rc = SQLITE_OK;
+    sqlite3_int64 size = 0;
+    String method;
+
+    // In-memory databases loaded by load_from_file() or deserialize() are one contiguous
+    // buffer, which is written out directly
+    unsigned char* image = sqlite3_serialize(_db, schema.get_data(), &size, SQLITE_SERIALIZE_NOCOPY);
+    if (image) {
+        method = "nocopy";
+        writer.begin(size);
+        writer.write(image, size);
+    } else {
+        // Anything else is streamed one page at a time through the sqlite_dbpage table,
+        // inside a read transaction so the pages are consistent
+        sqlite3_stmt* stmt = nullptr;
+        bool own_transaction = sqlite3_get_autocommit(_db) != 0;
+        if (own_transaction) sqlite3_exec(_db, "BEGIN", nullptr, nullptr, nullptr);
+        rc = sqlite3_prepare_v2(_db, "SELECT data FROM sqlite_dbpage(?1) ORDER BY pgno", -1, &stmt, nullptr);
+        if (rc == SQLITE_OK) {
+            method = "dbpage";
+            sqlite3_gd_workload::bind_text(stmt, 1, schema.get_data(), schema.length(), SQLITE_STATIC);
+            sqlite3_stmt* count = nullptr;
+            const char* count_sql = "SELECT page_count * page_size FROM pragma_page_count(?1), pragma_page_size(?1)";
+            if (sqlite3_prepare_v2(_db, count_sql, -1, &count, nullptr) == SQLITE_OK) {
+                sqlite3_gd_workload::bind_text(count, 1, schema.get_data(), schema.length(), SQLITE_STATIC);
+                if (sqlite3_step(count) == SQLITE_ROW) size = sqlite3_column_int64(count, 0);
+            }
+            sqlite3_gd_workload::finalize(count);
+            writer.begin(size);
+            bool first = true;
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                const uint8_t* page = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 0));
+                int bytes = sqlite3_column_bytes(stmt, 0);
+                if (first) {
+                    save_write_first_page(writer, page, bytes);
+                    first = false;
+                } else {
+                    writer.write(page, bytes);
+                }
+            }
+            if (rc == SQLITE_DONE) rc = SQLITE_OK;
+            sqlite3_gd_workload::finalize(stmt);
+        } else {
+            // Without sqlite_dbpage, fall back to a single copy of the database
+            method = "copy";
+            image = sqlite3_serialize(_db, schema.get_data(), &size, 0);
+            if (image) {
+                rc = SQLITE_OK;
+                if (size > 19 && image[18] == 2 && image[19] == 2) {
+                    image[18] = 1;
+                    image[19] = 1;
+                }
+                writer.begin(size);
+                writer.write(image, size);
+                sqlite3_free(image);
+            } else {
+                rc = SQLITE_NOMEM;
+            }
+        }
+        if (own_transaction) sqlite3_exec(_db, "COMMIT", nullptr, nullptr, nullptr);
+    }
+    writer.finish();
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr("Save error: ", errmsg());
+    } else if (writer.failed || writer.file->get_error() != OK) {
+        UtilityFunctions::printerr("Save error: cannot write ", temp_path);
+        rc = SQLITE_IOERR;
+    }
+    int64_t file_bytes = (int64_t)writer.file->get_length();
+    writer.file->close();
+
+    if (rc == SQLITE_OK && DirAccess::rename_absolute(temp_path, path) != OK) {
+        UtilityFunctions::printerr("Save error: cannot replace ", path);
+        rc = SQLITE_IOERR;
+    }
+    if (rc != SQLITE_OK) DirAccess::remove_absolute(temp_path);
+
+    result["rc"] = rc;
+    result["method"] = method;
+    result["bytes"] = (int64_t)size;
+    result["file_bytes"] = file_bytes;
+    result["usec"] = (int64_t)(Time::get_singleton()->get_ticks_usec() - start);
+    return result;
+}
+
+Dictionary SQLite3Database::load_from_file(const String& path, const String& zSchema, bool read_only) {
+    Dictionary result;
+    result["rc"] = SQLITE_MISUSE;
+    if (!_db) return result;
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+    if (file.is_null()) {
+        UtilityFunctions::printerr("Load error: cannot open ", path);
+        result["rc"] = SQLITE_CANTOPEN;
+        return result;
+    }
+    int64_t file_bytes = file->get_length();
+    sqlite3_int64 size = file_bytes;
+    int compression = -1;
+    uint32_t block_size = 0;
+    if (file_bytes >= SAVE_HEADER_SIZE) {
+        uint8_t magic[4];
+        file->get_buffer(magic, 4);
+        if (memcmp(magic, SAVE_MAGIC, 4) == 0) {
+            compression = (int)file->get_32();
+            block_size = file->get_32();
+            size = (int64_t)file->get_64();
+        } else {
+            file->seek(0);
+        }
+    }
+    // Every block takes at least its size word, so a header claiming more blocks than the
+    // file can hold is rejected before the buffer is allocated
+    if (compression >= 0 && (block_size == 0 || block_size > SAVE_BLOCK_SIZE || size < 0 ||
+                             (size + block_size - 1) / block_size * 4 > file_bytes - SAVE_HEADER_SIZE)) {
+        UtilityFunctions::printerr("Load error: ", path, " has an invalid header");
+        result["rc"] = SQLITE_CORRUPT;
+        return result;
+    }
+
+    // SQLite takes ownership of the buffer, the file is read straight into it
+    unsigned char* buffer = static_cast<unsigned char*>(sqlite3_malloc64(size > 0 ? size : 1));
+    if (!buffer) {
+        result["rc"] = SQLITE_NOMEM;
+        return result;
+    }
+    int64_t loaded = 0;
+    if (compression < 0) {
+        loaded = (int64_t)file->get_buffer(buffer, size);
+    } else {
+        while (loaded < size && !file->eof_reached()) {
+            uint32_t packed_size = file->get_32();
+            if ((int64_t)packed_size > file_bytes - (int64_t)file->get_position()) break;
+            PackedByteArray packed = file->get_buffer(packed_size);
+            int64_t expected = std::min((int64_t)block_size, (int64_t)(size - loaded));
+            PackedByteArray block = packed.decompress(expected, compression);
+            if (block.size() != expected) break;
+            memcpy(buffer + loaded, block.ptr(), expected);
+            loaded += expected;
+        }
+    }
+    file->close();
+
+    int rc;
+    if (loaded != size) {
+        sqlite3_free(buffer);
+        UtilityFunctions::printerr("Load error: ", path, " is truncated or corrupt");
+        rc = SQLITE_CORRUPT;
+    } else {
+        // A WAL-mode file cannot be used as an in-memory database, open it in rollback mode
+        if (size > 19 && buffer[18] == 2 && buffer[19] == 2) {
+            buffer[18] = 1;
+            buffer[19] = 1;
+        }
+        unsigned int flags = SQLITE_DESERIALIZE_FREEONCLOSE |
+                             (read_only ? SQLITE_DESERIALIZE_READONLY : SQLITE_DESERIALIZE_RESIZEABLE);
+        rc = sqlite3_deserialize(_db, zSchema.utf8().get_data(), buffer, size, size, flags);
+        if (rc != SQLITE_OK) {
+            UtilityFunctions::printerr("Load error: ", errmsg());
+        }
+    }
+
+    result["rc"] = rc;
+    result["bytes"] = (int64_t)size;
+    result["file_bytes"] = file_bytes;
+    result["usec"] = (int64_t)(Time::get_singleton()->get_ticks_usec() - start);
+    return result;
 }
 
 int SQLite3Database::rtree_geometry_callback(const String& zGeom, Callable xGeom, Variant pContext) {
@@ -498,6 +2075,16 @@ void SQLite3Database::_bind_methods() {
     ClassDB::bind_method(D_METHOD("prepare", "sql", "nByte"), &SQLite3Database::prepare, DEFVAL(-1));
     ClassDB::bind_method(D_METHOD("prepare_v2", "sql", "nByte"), &SQLite3Database::prepare_v2, DEFVAL(-1));
     ClassDB::bind_method(D_METHOD("prepare_v3", "sql", "nByte", "prepFlags"), &SQLite3Database::prepare_v3, DEFVAL(-1), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("set_statement_cache_size", "size"), &SQLite3Database::set_statement_cache_size);
+    ClassDB::bind_method(D_METHOD("get_statement_cache_size"), &SQLite3Database::get_statement_cache_size);
+    ClassDB::bind_method(D_METHOD("clear_statement_cache"), &SQLite3Database::clear_statement_cache);
+    ClassDB::bind_method(D_METHOD("statement_cache_stats"), &SQLite3Database::statement_cache_stats);
+    ClassDB::bind_method(D_METHOD("execute_batch", "sql", "rows", "atomic"), &SQLite3Database::execute_batch, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("execute_batch_columns", "sql", "columns", "atomic"), &SQLite3Database::execute_batch_columns, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("exec_async", "sql"), &SQLite3Database::exec_async);
+    ClassDB::bind_method(D_METHOD("query_async", "sql", "params"), &SQLite3Database::query_async, DEFVAL(Array()));
+    ClassDB::bind_method(D_METHOD("blob_import_async", "path", "zTable", "zColumn", "iRow", "zDb"),
+                         &SQLite3Database::blob_import_async, DEFVAL("main"));
     ClassDB::bind_method(D_METHOD("get_table", "sql"), &SQLite3Database::get_table);
     ClassDB::bind_method(D_METHOD("query", "sql"), &SQLite3Database::query);
     ClassDB::bind_method(D_METHOD("backup_init", "zDestName", "destDb", "zSrcName"), &SQLite3Database::backup_init);
@@ -509,13 +2096,43 @@ void SQLite3Database::_bind_methods() {
     ClassDB::bind_method(D_METHOD("txn_state", "zSchema"), &SQLite3Database::txn_state, DEFVAL(String()));
     ClassDB::bind_method(D_METHOD("next_stmt", "pStmt"), &SQLite3Database::next_stmt);
     ClassDB::bind_method(D_METHOD("busy_handler", "handler"), &SQLite3Database::busy_handler);
+    ClassDB::bind_method(D_METHOD("progress_handler", "n_ops", "handler"), &SQLite3Database::progress_handler);
+    ClassDB::bind_method(D_METHOD("set_query_deadline", "usec"), &SQLite3Database::set_query_deadline);
+    ClassDB::bind_method(D_METHOD("get_query_deadline"), &SQLite3Database::get_query_deadline);
+    ClassDB::bind_method(D_METHOD("get_last_interrupt"), &SQLite3Database::get_last_interrupt);
+    ClassDB::bind_method(D_METHOD("enable_profiling", "enable"), &SQLite3Database::enable_profiling, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("is_profiling"), &SQLite3Database::is_profiling);
+    ClassDB::bind_method(D_METHOD("get_profile"), &SQLite3Database::get_profile);
+    ClassDB::bind_method(D_METHOD("reset_profile"), &SQLite3Database::reset_profile);
+    ClassDB::bind_static_method("SQLite3Database", D_METHOD("peek_statement_events"), &SQLite3Database::peek_statement_events);
+    ClassDB::bind_method(D_METHOD("register_monitors", "label"), &SQLite3Database::register_monitors, DEFVAL(String()));
+    ClassDB::bind_method(D_METHOD("unregister_monitors"), &SQLite3Database::unregister_monitors);
+    ClassDB::bind_method(D_METHOD("start_capture", "path"), &SQLite3Database::start_capture);
+    ClassDB::bind_method(D_METHOD("stop_capture"), &SQLite3Database::stop_capture);
+    ClassDB::bind_method(D_METHOD("is_capturing"), &SQLite3Database::is_capturing);
+    ClassDB::bind_method(D_METHOD("replay_workload", "path", "speed"), &SQLite3Database::replay_workload, DEFVAL(0.0));
     ClassDB::bind_method(D_METHOD("commit_hook", "hook"), &SQLite3Database::commit_hook);
     ClassDB::bind_method(D_METHOD("rollback_hook", "hook"), &SQLite3Database::rollback_hook);
     ClassDB::bind_method(D_METHOD("update_hook", "hook"), &SQLite3Database::update_hook);
+    ClassDB::bind_method(D_METHOD("set_authorizer", "authorizer"), &SQLite3Database::set_authorizer);
     ClassDB::bind_method(D_METHOD("autovacuum_pages", "callback"), &SQLite3Database::autovacuum_pages);
     ClassDB::bind_method(D_METHOD("enable_load_extension", "onoff"), &SQLite3Database::enable_load_extension);
     ClassDB::bind_method(D_METHOD("load_extension", "zFile", "zProc"), &SQLite3Database::load_extension, DEFVAL(String()));
+    ClassDB::bind_method(D_METHOD("create_module", "zName", "pModule"), &SQLite3Database::create_module);
     ClassDB::bind_method(D_METHOD("declare_vtab", "zSQL"), &SQLite3Database::declare_vtab);
+    ClassDB::bind_method(D_METHOD("create_function", "name", "n_args", "func", "flags"), &SQLite3Database::create_function, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("create_aggregate", "name", "n_args", "step", "final", "flags", "initial"), &SQLite3Database::create_aggregate, DEFVAL(0), DEFVAL(Variant()));
+    ClassDB::bind_method(D_METHOD("create_window_function", "name", "n_args", "step", "inverse", "value", "final", "flags", "initial"), &SQLite3Database::create_window_function, DEFVAL(0), DEFVAL(Variant()));
+    ClassDB::bind_method(D_METHOD("remove_function", "name", "n_args"), &SQLite3Database::remove_function);
+    ClassDB::bind_method(D_METHOD("session_create", "zDb"), &SQLite3Database::session_create, DEFVAL("main"));
+    ClassDB::bind_method(D_METHOD("changeset_apply", "changeset", "on_conflict", "filter", "flags"), &SQLite3Database::changeset_apply, DEFVAL(Variant()), DEFVAL(Callable()), DEFVAL(0));
+    ClassDB::bind_static_method("SQLite3Database", D_METHOD("changeset_invert", "changeset"), &SQLite3Database::changeset_invert);
+    ClassDB::bind_static_method("SQLite3Database", D_METHOD("changeset_concat", "a", "b"), &SQLite3Database::changeset_concat);
+    ClassDB::bind_static_method("SQLite3Database", D_METHOD("changeset_changes", "changeset"), &SQLite3Database::changeset_changes);
+    ClassDB::bind_method(D_METHOD("snapshot_get", "zSchema"), &SQLite3Database::snapshot_get, DEFVAL("main"));
+    ClassDB::bind_method(D_METHOD("snapshot_open", "snapshot", "zSchema"), &SQLite3Database::snapshot_open, DEFVAL("main"));
+    ClassDB::bind_method(D_METHOD("snapshot_recover", "zDb"), &SQLite3Database::snapshot_recover, DEFVAL("main"));
+    ClassDB::bind_static_method("SQLite3Database", D_METHOD("snapshot_cmp", "a", "b"), &SQLite3Database::snapshot_cmp);
     ClassDB::bind_method(D_METHOD("overload_function", "zFuncName", "nArg"), &SQLite3Database::overload_function);
     ClassDB::bind_method(D_METHOD("blob_open", "zDb", "zTable", "zColumn", "iRow", "flags"), &SQLite3Database::blob_open);
     ClassDB::bind_method(D_METHOD("file_control", "zDbName", "op", "pArg"), &SQLite3Database::file_control, DEFVAL(Variant()));
@@ -523,7 +2140,9 @@ void SQLite3Database::_bind_methods() {
     ClassDB::bind_method(D_METHOD("db_cacheflush"), &SQLite3Database::db_cacheflush);
     ClassDB::bind_method(D_METHOD("system_errno"), &SQLite3Database::system_errno);
     ClassDB::bind_method(D_METHOD("serialize", "zSchema", "mFlags"), &SQLite3Database::serialize, DEFVAL(String()), DEFVAL(0));
-    ClassDB::bind_method(D_METHOD("deserialize", "zSchema", "pData", "szDb", "szBuf", "mFlags"), &SQLite3Database::deserialize);
+    ClassDB::bind_method(D_METHOD("deserialize", "zSchema", "pData", "szDb", "szBuf", "mFlags"), &SQLite3Database::deserialize, DEFVAL(-1), DEFVAL(-1), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("save_to_file", "path", "zSchema", "compression"), &SQLite3Database::save_to_file, DEFVAL("main"), DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("load_from_file", "path", "zSchema", "read_only"), &SQLite3Database::load_from_file, DEFVAL("main"), DEFVAL(false));
     ClassDB::bind_method(D_METHOD("limit", "id", "newVal"), &SQLite3Database::limit);
     ClassDB::bind_method(D_METHOD("table_column_metadata", "zDbName", "zTableName", "zColumnName"), &SQLite3Database::table_column_metadata);
     ClassDB::bind_method(D_METHOD("db_release_memory"), &SQLite3Database::db_release_memory);
@@ -565,6 +2184,10 @@ void SQLite3Database::_bind_methods() {
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_ROW"), SQLITE_ROW);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DONE"), SQLITE_DONE);
 
+    // Authorizer results
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DENY"), SQLITE_DENY);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_IGNORE"), SQLITE_IGNORE);
+
     // Open flags
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_OPEN_READONLY"), SQLITE_OPEN_READONLY);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_OPEN_READWRITE"), SQLITE_OPEN_READWRITE);
@@ -603,6 +2226,30 @@ void SQLite3Database::_bind_methods() {
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_UTF16BE"), SQLITE_UTF16BE);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_UTF16LE"), SQLITE_UTF16LE);
 
+    // Function flags
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DETERMINISTIC"), SQLITE_DETERMINISTIC);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DIRECTONLY"), SQLITE_DIRECTONLY);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_INNOCUOUS"), SQLITE_INNOCUOUS);
+
+    // serialize() and deserialize() flags
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_SERIALIZE_NOCOPY"), SQLITE_SERIALIZE_NOCOPY);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DESERIALIZE_FREEONCLOSE"), SQLITE_DESERIALIZE_FREEONCLOSE);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DESERIALIZE_RESIZEABLE"), SQLITE_DESERIALIZE_RESIZEABLE);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_DESERIALIZE_READONLY"), SQLITE_DESERIALIZE_READONLY);
+
+    // Changeset conflict types, conflict actions and changeset_apply() flags
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_DATA"), SQLITE_CHANGESET_DATA);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_NOTFOUND"), SQLITE_CHANGESET_NOTFOUND);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_CONFLICT"), SQLITE_CHANGESET_CONFLICT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_CONSTRAINT"), SQLITE_CHANGESET_CONSTRAINT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_FOREIGN_KEY"), SQLITE_CHANGESET_FOREIGN_KEY);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_OMIT"), SQLITE_CHANGESET_OMIT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_REPLACE"), SQLITE_CHANGESET_REPLACE);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESET_ABORT"), SQLITE_CHANGESET_ABORT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESETAPPLY_NOSAVEPOINT"), SQLITE_CHANGESETAPPLY_NOSAVEPOINT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESETAPPLY_INVERT"), SQLITE_CHANGESETAPPLY_INVERT);
+    ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_CHANGESETAPPLY_IGNORENOOP"), SQLITE_CHANGESETAPPLY_IGNORENOOP);
+
     // Limit constants
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_LIMIT_LENGTH"), SQLITE_LIMIT_LENGTH);
     ClassDB::bind_integer_constant(get_class_static(), StringName(), StringName("SQLITE_LIMIT_SQL_LENGTH"), SQLITE_LIMIT_SQL_LENGTH);
@@ -17,15 +17,33 @@
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
 
 #include <sqlite3.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 using namespace godot;
 
 class SQLite3Statement;
 class SQLite3ResultSet;
 class SQLite3Backup;
 class SQLite3Blob;
+class SQLite3Task;
+class SQLite3Session;
+class SQLite3Snapshot;
+struct UserFunction;
+
+namespace sqlite3_gd_prof {
+class Profiler;
+}
+
+namespace sqlite3_gd_workload {
+class Recorder;
+}
 
 /**
  * SQLite3Database
@@ -41,12 +59,107 @@ protected:
 private:
     sqlite3* _db;
 
+    // Prepared statement cache (LRU, keyed by SQL text, oldest entry first). It only holds idle
+    // statements: prepare() takes them out and SQLite3Statement::finalize() puts them back.
+    // The same database may be used from several threads, so access is locked.
+    HashMap<String, Ref<SQLite3Statement>> _stmt_cache;
+    std::recursive_mutex _stmt_cache_mutex;
+    std::atomic<int> _stmt_cache_capacity;
+    int64_t _stmt_cache_hits;
+    int64_t _stmt_cache_misses;
+    int64_t _stmt_cache_evictions;
+
+    // Open sessions, deleted before the handle is closed
+    HashSet<SQLite3Session*> _sessions;
+
+    void _on_open();
+    Ref<SQLite3Statement> _prepare_cached(const String& sql, unsigned int prepFlags, const char* error_prefix);
+    void _trim_statement_cache(int capacity);
+    void _wait_async_tasks();
+    void _close_sessions();
+    int _begin_snapshot_read(const String& zSchema);  // BEGIN and read, so the WAL is open
+    void _update_progress_handler();
+    void _update_trace();
+
+    // Performance monitors, sampled by the engine through _sample_monitor()
+    enum Monitor {
+        MONITOR_HEAP_BYTES,
+        MONITOR_CONNECTION_BYTES,
+        MONITOR_CACHE_HITS,
+        MONITOR_CACHE_MISSES,
+        MONITOR_CACHE_WRITES,
+        MONITOR_LOOKASIDE_USED,
+        MONITOR_STATEMENTS,
+        MONITOR_SQLITE_USEC,
+        MONITOR_WAL_BYTES,
+        MONITOR_MAX,
+    };
+    struct MonitorRate {
+        uint64_t last_counter = 0;
+        uint64_t last_frame = 0;
+        double per_frame = 0.0;
+    };
+    String _monitor_category;
+    MonitorRate _monitor_rates[MONITOR_MAX];
+    double _sample_monitor(int monitor);
+    uint64_t _monitor_counter(int monitor);
+    double _per_frame(int monitor, uint64_t counter);
+    int64_t _wal_bytes();
+    int _create_user_function(const String& name, int n_args, int flags, UserFunction* fn, bool aggregate, bool window);
+
 public:
     Callable _busy_handler;
     Callable _commit_hook;
     Callable _rollback_hook;
     Callable _update_hook;
+    Callable _authorizer;
     Callable _autovacuum_callback;
+    Callable _progress_handler;
+    int _progress_ops;              // VM instructions between two calls of _progress_handler
+    int64_t _progress_ops_pending;  // Instructions run since the last call of _progress_handler
+    int _progress_period;           // Period the native progress callback is installed with
+    int64_t _query_deadline_usec;   // Per-statement time limit, 0 if none
+    sqlite3_stmt* _stmt_running;    // Statement started or resumed last, the one the deadline is checked for
+    Dictionary _last_interrupt;
+    std::unique_ptr<sqlite3_gd_prof::Profiler> _profiler;  // Set while profiling or until the data is reset
+    std::atomic<bool> _profiling;
+    std::atomic<bool> _monitoring;
+    std::atomic<uint64_t> _statements_run;  // Finished statements, counted while monitoring
+    std::atomic<uint64_t> _statements_ns;   // Their total run time
+    struct RunningStatement {
+        uint64_t start_ns = 0;
+        uint64_t resumed_ns = 0;  // Start of the call now stepping it, the deadline counts from here
+        uint64_t rows = 0;
+    };
+    HashMap<sqlite3_stmt*, RunningStatement> _running_stmts;  // Statements started while traced
+    std::shared_ptr<sqlite3_gd_workload::Recorder> _recorder;  // Set while capturing, swapped under the connection mutex
+    uint64_t _capture_start_usec;
+
+    // Re-installs the trace callback of every open connection, after debugger events were toggled
+    static void _update_all_traces();
+    // Restarts the query deadline of a statement that a new call from script steps again, and applies
+    // a trace change deferred on its connection
+    static void _resume_statement(sqlite3_stmt* stmt);
+    // Connections without a mutex may be in use on another thread, so _update_all_traces() only marks
+    // them and the thread using one next applies the change
+    std::atomic<bool> _trace_stale;
+    void _apply_stale_trace();
+    void _apply_deferred_trace() {
+        if (_trace_stale.load(std::memory_order_relaxed)) _apply_stale_trace();
+    }
+    std::atomic<bool> _stmt_cache_stale;
+
+    // Worker thread jobs using the handle (SQLite3Task, threaded SQLite3Backup), cancelled and
+    // joined before it is closed
+    std::mutex _async_mutex;
+    HashSet<SQLite3Task*> _async_tasks;
+    HashSet<SQLite3Backup*> _async_backups;
+
+    // Takes back a statement handed out by the cache, already reset. Returns false if it is not wanted.
+    bool _return_to_cache(const Ref<SQLite3Statement>& stmt, const String& sql);
+    void _remove_session(SQLite3Session* session);
+    void _track_task(SQLite3Task* task, bool pending);
+    void _track_backup(SQLite3Backup* backup, bool pending);
 
 public:
     // Constructors
@@ -95,11 +208,51 @@ public:
     int busy_timeout(int ms);
     int setlk_timeout(int ms, int flags);
 
+    // Progress handler and query deadline
+    int progress_handler(int n_ops, Callable handler);
+    void set_query_deadline(int64_t usec);
+    int64_t get_query_deadline();
+    Dictionary get_last_interrupt();
+
+    // Per-SQL latency profiling through sqlite3_trace_v2
+    void enable_profiling(bool enable = true);
+    bool is_profiling();
+    Dictionary get_profile();
+    void reset_profile();
+    // Events of the "sqlite" debugger profiler, for in-game views
+    static Array peek_statement_events();
+
+    // Godot Performance custom monitors for this connection
+    int register_monitors(const String& label = String());
+    void unregister_monitors();
+
+    // Workload capture and replay
+    int start_capture(const String& path);
+    Dictionary stop_capture();
+    bool is_capturing();
+    Dictionary replay_workload(const String& path, double speed = 0.0);
+
     // Prepare statement
     Ref<SQLite3Statement> prepare(const String& sql, int nByte = -1);
     Ref<SQLite3Statement> prepare_v2(const String& sql, int nByte = -1);
     Ref<SQLite3Statement> prepare_v3(const String& sql, int nByte = -1, unsigned int prepFlags = 0);
 
+    // Statement cache
+    void set_statement_cache_size(int size);
+    int get_statement_cache_size();
+    void clear_statement_cache();
+    Dictionary statement_cache_stats();
+
+    // Batch execution (one prepare, native binding, single savepoint)
+    Dictionary execute_batch(const String& sql, const Array& rows, bool atomic = true);
+    Dictionary execute_batch_columns(const String& sql, const Array& columns, bool atomic = true);
+
+    // Asynchronous execution on the WorkerThreadPool
+    Ref<SQLite3Task> exec_async(const String& sql);
+    Ref<SQLite3Task> query_async(const String& sql, const Array& params = Array());
+    Ref<SQLite3Task> blob_import_async(const String& path, const String& zTable, const String& zColumn, int64_t iRow,
+                                       const String& zDb = "main");
+
     // Get table (simplified)
     Array get_table(const String& sql);  // Returns array of arrays
 
@@ -127,6 +280,7 @@ public:
     void commit_hook(Callable hook);
     void rollback_hook(Callable hook);
     void update_hook(Callable hook);
+    void set_authorizer(Callable authorizer);
 
     // Autovacuum pages
     int autovacuum_pages(Callable callback);
@@ -142,12 +296,34 @@ public:
     static int cancel_auto_extension(Callable xEntryPoint);
     static void reset_auto_extension();
 
-    // Create module
-    int create_module(const String& zName, Variant pModule);  // Simplified
+    // Create module: eponymous virtual table over a Dictionary of columns or an Array of rows
+    int create_module(const String& zName, Variant pModule);
 
     // Declare VTab
     int declare_vtab(const String& zSQL);
 
+    // User-defined functions
+    int create_function(const String& name, int n_args, Callable func, int flags = 0);
+    int create_aggregate(const String& name, int n_args, Callable step, Callable final, int flags = 0,
+                         const Variant& initial = Variant());
+    int create_window_function(const String& name, int n_args, Callable step, Callable inverse, Callable value,
+                               Callable final, int flags = 0, const Variant& initial = Variant());
+    int remove_function(const String& name, int n_args);
+
+    // Sessions and changesets
+    Ref<SQLite3Session> session_create(const String& zDb = "main");
+    int changeset_apply(const PackedByteArray& changeset, const Variant& on_conflict = Variant(),
+                        Callable filter = Callable(), int flags = 0);
+    static PackedByteArray changeset_invert(const PackedByteArray& changeset);
+    static PackedByteArray changeset_concat(const PackedByteArray& a, const PackedByteArray& b);
+    static Array changeset_changes(const PackedByteArray& changeset);
+
+    // Snapshots of WAL databases
+    Ref<SQLite3Snapshot> snapshot_get(const String& zSchema = "main");
+    int snapshot_open(const Ref<SQLite3Snapshot>& snapshot, const String& zSchema = "main");
+    int snapshot_recover(const String& zDb = "main");
+    static int snapshot_cmp(const Ref<SQLite3Snapshot>& a, const Ref<SQLite3Snapshot>& b);
+
     // Overload function
     int overload_function(const String& zFuncName, int nArg);
 
@@ -168,7 +344,12 @@ public:
 
     // Serialize/Deserialize
     Array serialize(const String& zSchema, unsigned int mFlags = 0);
-    int deserialize(const String& zSchema, const PackedByteArray& pData, int64_t szDb, int64_t szBuf, unsigned int mFlags);
+    int deserialize(const String& zSchema, const PackedByteArray& pData, int64_t szDb = -1, int64_t szBuf = -1,
+                    unsigned int mFlags = 0);
+
+    // Save games: stream the database image to and from a file without intermediate copies
+    Dictionary save_to_file(const String& path, const String& zSchema = "main", int compression = -1);
+    Dictionary load_from_file(const String& path, const String& zSchema = "main", bool read_only = false);
 
     // Rtree callbacks
     int rtree_geometry_callback(const String& zGeom, Callable xGeom, Variant pContext);
@@ -0,0 +1,82 @@
+#include "SQLite3DebuggerProfiler.h"
+#include "SQLite3Database.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/engine_debugger.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+static Ref<SQLite3DebuggerProfiler> debugger_profiler;
+
+SQLite3DebuggerProfiler::SQLite3DebuggerProfiler() : _frame(0) {}
+
+void SQLite3DebuggerProfiler::_toggle(bool p_enable, const Array& p_options) {
+    sqlite3_gd_prof::set_events_enabled(p_enable);
+    SQLite3Database::_update_all_traces();
+    // Start from an empty buffer, events recorded while disabled are stale
+    _events.clear();
+    sqlite3_gd_prof::drain_events(_events);
+    _events.clear();
+}
+
+void SQLite3DebuggerProfiler::_add_frame(const Array& p_data) {}
+
+void SQLite3DebuggerProfiler::_tick(double p_frame_time, double p_process_time, double p_physics_time,
+                                    double p_physics_frame_time) {
+    if (!sqlite3_gd_prof::events_enabled()) return;
+    _events.clear();
+    uint64_t dropped = sqlite3_gd_prof::drain_events(_events);
+    _frame = Engine::get_singleton()->get_process_frames();
+
+    // [frame, dropped, total_usec, [end_usec, duration_usec, rows, thread, sql]...]
+    double total_usec = 0.0;
+    Array events = events_to_array(_events, &total_usec);
+    Array message;
+    message.append((int64_t)_frame);
+    message.append((int64_t)dropped);
+    message.append(total_usec);
+    message.append(events);
+    EngineDebugger::get_singleton()->send_message("sqlite:frame", message);
+}
+
+Array SQLite3DebuggerProfiler::events_to_array(std::vector<sqlite3_gd_prof::StatementEvent>& events, double* total_usec) {
+    // Rings are drained thread by thread, the editor gets them in time order
+    std::sort(events.begin(), events.end(),
+              [](const sqlite3_gd_prof::StatementEvent& a, const sqlite3_gd_prof::StatementEvent& b) {
+                  return a.end_usec < b.end_usec;
+              });
+    Array result;
+    result.resize(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        const sqlite3_gd_prof::StatementEvent& event = events[i];
+        Array entry;
+        entry.append((int64_t)event.end_usec);
+        entry.append(event.duration_ns / 1000.0);
+        entry.append((int64_t)event.rows);
+        entry.append((int64_t)event.thread);
+        entry.append(String::utf8(event.sql));
+        result[i] = entry;
+        if (total_usec) *total_usec += event.duration_ns / 1000.0;
+    }
+    return result;
+}
+
+void SQLite3DebuggerProfiler::register_profiler() {
+    EngineDebugger* debugger = EngineDebugger::get_singleton();
+    if (!debugger || debugger->has_profiler(NAME)) return;
+    debugger_profiler.instantiate();
+    debugger->register_profiler(NAME, debugger_profiler);
+}
+
+void SQLite3DebuggerProfiler::unregister_profiler() {
+    if (debugger_profiler.is_null()) return;
+    EngineDebugger* debugger = EngineDebugger::get_singleton();
+    if (debugger && debugger->has_profiler(NAME)) debugger->unregister_profiler(NAME);
+    sqlite3_gd_prof::set_events_enabled(false);
+    debugger_profiler.unref();
+}
+
+void SQLite3DebuggerProfiler::_bind_methods() {}
@@ -0,0 +1,60 @@
+#ifndef _SQLITE3_DEBUGGER_PROFILER_H
+#define _SQLITE3_DEBUGGER_PROFILER_H
+
+/**
+ * SQLite3DebuggerProfiler.h
+ *
+ * EngineDebugger profiler "sqlite" reporting database activity per frame.
+ *
+ * While the profiler is enabled from the debugger, every statement finished on
+ * a connection opened through SQLite3Database is recorded with its SQL, run
+ * time and row count into a per-thread ring (see SQLite3Profiler.h). Once per
+ * frame the rings are drained and sent to the editor as a "sqlite:frame"
+ * message, which an EditorDebuggerPlugin can show next to the frame timings.
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/classes/engine_profiler.hpp>
+
+#include "SQLite3Profiler.h"
+
+#include <vector>
+
+using namespace godot;
+
+/**
+ * SQLite3DebuggerProfiler
+ *
+ * EngineProfiler sending statement events to the remote debugger.
+ */
+class SQLite3DebuggerProfiler : public EngineProfiler {
+    GDCLASS(SQLite3DebuggerProfiler, EngineProfiler);
+
+protected:
+    static void _bind_methods();
+
+private:
+    std::vector<sqlite3_gd_prof::StatementEvent> _events;  // Reused between frames
+    uint64_t _frame;
+
+public:
+    static constexpr const char* NAME = "sqlite";
+
+    SQLite3DebuggerProfiler();
+
+    virtual void _toggle(bool p_enable, const Array& p_options) override;
+    virtual void _add_frame(const Array& p_data) override;
+    virtual void _tick(double p_frame_time, double p_process_time, double p_physics_time,
+                       double p_physics_frame_time) override;
+
+    // Sorts events into time order and converts them to the [end_usec, duration_usec, rows, thread, sql]
+    // entries of a "sqlite:frame" message, adding their run time to total_usec when given
+    static Array events_to_array(std::vector<sqlite3_gd_prof::StatementEvent>& events, double* total_usec = nullptr);
+
+    // Registration with the EngineDebugger, done by the extension initializer
+    static void register_profiler();
+    static void unregister_profiler();
+};
+
+#endif // _SQLITE3_DEBUGGER_PROFILER_H
@@ -0,0 +1,268 @@
+#include "SQLite3GodotVFS.h"
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+const char* SQLite3GodotVFS::NAME = "godot";
+
+static sqlite3_vfs godot_vfs;
+static bool godot_vfs_registered = false;
+
+static sqlite3_vfs* default_vfs() {
+    return static_cast<sqlite3_vfs*>(godot_vfs.pAppData);
+}
+
+static bool is_res_path(const char* path) {
+    return path && strncmp(path, "res://", 6) == 0;
+}
+
+bool SQLite3GodotVFS::is_godot_path(const String& path) {
+    return path.begins_with("res://") || path.begins_with("user://");
+}
+
+// ---------------------------------------------------------------------------
+// Read-only res:// files
+
+// State of one open res:// file, owned by GodotResFile
+struct GodotResData {
+    Ref<FileAccess> file;
+    int64_t size = 0;
+    PackedByteArray preload;  // Whole file when it is small enough, otherwise empty
+
+    struct Block {
+        int64_t index = -1;
+        PackedByteArray bytes;
+    };
+    Block blocks[SQLite3GodotVFS::CACHE_BLOCKS];
+
+    const PackedByteArray* block(int64_t index) {
+        Block& slot = blocks[index % SQLite3GodotVFS::CACHE_BLOCKS];
+        if (slot.index != index) {
+            file->seek(index * SQLite3GodotVFS::CACHE_BLOCK_SIZE);
+            slot.bytes = file->get_buffer(SQLite3GodotVFS::CACHE_BLOCK_SIZE);
+            slot.index = file->get_error() == OK || file->eof_reached() ? index : -1;
+        }
+        return slot.index == index ? &slot.bytes : nullptr;
+    }
+};
+
+struct GodotResFile {
+    sqlite3_file base;
+    GodotResData* data;
+};
+
+static int res_close(sqlite3_file* file) {
+    GodotResFile* res = reinterpret_cast<GodotResFile*>(file);
+    memdelete(res->data);
+    res->data = nullptr;
+    return SQLITE_OK;
+}
+
+static int res_read(sqlite3_file* file, void* buffer, int amount, sqlite3_int64 offset) {
+    GodotResData* data = reinterpret_cast<GodotResFile*>(file)->data;
+    uint8_t* dst = static_cast<uint8_t*>(buffer);
+    int64_t available = offset < data->size ? data->size - offset : 0;
+    int64_t wanted = amount < available ? amount : available;
+
+    if (!data->preload.is_empty()) {
+        if (wanted > 0) memcpy(dst, data->preload.ptr() + offset, wanted);
+    } else {
+        int64_t done = 0;
+        while (done < wanted) {
+            int64_t position = offset + done;
+            const PackedByteArray* bytes = data->block(position / SQLite3GodotVFS::CACHE_BLOCK_SIZE);
+            if (!bytes) return SQLITE_IOERR_READ;
+            int64_t in_block = position % SQLite3GodotVFS::CACHE_BLOCK_SIZE;
+            int64_t chunk = bytes->size() - in_block;
+            if (chunk <= 0) break;
+            if (chunk > wanted - done) chunk = wanted - done;
+            memcpy(dst + done, bytes->ptr() + in_block, chunk);
+            done += chunk;
+        }
+        wanted = done;
+    }
+
+    if (wanted < amount) {
+        // SQLite requires the unread tail to be zeroed
+        memset(dst + wanted, 0, amount - wanted);
+        return SQLITE_IOERR_SHORT_READ;
+    }
+    return SQLITE_OK;
+}
+
+static int res_write(sqlite3_file*, const void*, int, sqlite3_int64) {
+    return SQLITE_READONLY;
+}
+
+static int res_truncate(sqlite3_file*, sqlite3_int64) {
+    return SQLITE_READONLY;
+}
+
+static int res_sync(sqlite3_file*, int) {
+    return SQLITE_OK;
+}
+
+static int res_file_size(sqlite3_file* file, sqlite3_int64* size) {
+    *size = reinterpret_cast<GodotResFile*>(file)->data->size;
+    return SQLITE_OK;
+}
+
+static int res_lock(sqlite3_file*, int) {
+    return SQLITE_OK;
+}
+
+static int res_check_reserved_lock(sqlite3_file*, int* result) {
+    *result = 0;
+    return SQLITE_OK;
+}
+
+static int res_file_control(sqlite3_file*, int, void*) {
+    return SQLITE_NOTFOUND;
+}
+
+static int res_sector_size(sqlite3_file*) {
+    return 4096;
+}
+
+static int res_device_characteristics(sqlite3_file*) {
+    // Nothing can change the file underneath us, SQLite skips locks and journals
+    return SQLITE_IOCAP_IMMUTABLE;
+}
+
+static int res_fetch(sqlite3_file* file, sqlite3_int64 offset, int amount, void** out) {
+    GodotResData* data = reinterpret_cast<GodotResFile*>(file)->data;
+    // Preloaded files hand out pages in place, everything else falls back to xRead
+    if (!data->preload.is_empty() && offset + amount <= data->size) {
+        *out = (void*)(data->preload.ptr() + offset);
+    } else {
+        *out = nullptr;
+    }
+    return SQLITE_OK;
+}
+
+static int res_unfetch(sqlite3_file*, sqlite3_int64, void*) {
+    return SQLITE_OK;
+}
+
+static const sqlite3_io_methods res_io_methods = {
+    3,  // iVersion, for xFetch/xUnfetch
+    res_close,
+    res_read,
+    res_write,
+    res_truncate,
+    res_sync,
+    res_file_size,
+    res_lock,
+    res_lock,  // xUnlock
+    res_check_reserved_lock,
+    res_file_control,
+    res_sector_size,
+    res_device_characteristics,
+    nullptr,  // xShmMap, no WAL for read-only files
+    nullptr,  // xShmLock
+    nullptr,  // xShmBarrier
+    nullptr,  // xShmUnmap
+    res_fetch,
+    res_unfetch,
+};
+
+static int res_open(const char* name, sqlite3_file* file, int flags, int* out_flags) {
+    GodotResFile* res = reinterpret_cast<GodotResFile*>(file);
+    res->base.pMethods = nullptr;
+    res->data = nullptr;
+
+    // Only the database itself lives in res://, it is never journaled
+    if (!(flags & SQLITE_OPEN_MAIN_DB)) return SQLITE_CANTOPEN;
+
+    Ref<FileAccess> access = FileAccess::open(String::utf8(name), FileAccess::READ);
+    if (access.is_null()) return SQLITE_CANTOPEN;
+
+    GodotResData* data = memnew(GodotResData);
+    data->file = access;
+    data->size = access->get_length();
+    if (data->size <= sqlite3_uri_int64(name, "preload", SQLite3GodotVFS::DEFAULT_PRELOAD_LIMIT)) {
+        data->preload = access->get_buffer(data->size);
+        if (data->preload.size() != data->size) {
+            memdelete(data);
+            return SQLITE_IOERR_READ;
+        }
+        access->close();
+        data->file.unref();
+    }
+
+    res->data = data;
+    res->base.pMethods = &res_io_methods;
+    if (out_flags) *out_flags = (flags & ~(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) | SQLITE_OPEN_READONLY;
+    return SQLITE_OK;
+}
+
+// ---------------------------------------------------------------------------
+// VFS methods, res:// is handled here and everything else is delegated
+
+static int vfs_open(sqlite3_vfs*, const char* name, sqlite3_file* file, int flags, int* out_flags) {
+    if (is_res_path(name)) {
+        return res_open(name, file, flags, out_flags);
+    }
+    return default_vfs()->xOpen(default_vfs(), name, file, flags, out_flags);
+}
+
+static int vfs_delete(sqlite3_vfs*, const char* name, int sync_dir) {
+    if (is_res_path(name)) return SQLITE_IOERR_DELETE_NOENT;
+    return default_vfs()->xDelete(default_vfs(), name, sync_dir);
+}
+
+static int vfs_access(sqlite3_vfs*, const char* name, int flags, int* result) {
+    if (is_res_path(name)) {
+        // Journals and WAL files never exist next to a read-only resource
+        *result = flags == SQLITE_ACCESS_READWRITE ? 0 : FileAccess::file_exists(String::utf8(name));
+        return SQLITE_OK;
+    }
+    return default_vfs()->xAccess(default_vfs(), name, flags, result);
+}
+
+static int vfs_full_pathname(sqlite3_vfs*, const char* name, int out_size, char* out) {
+    if (is_res_path(name)) {
+        // Already absolute within the virtual file system
+        if ((int)strlen(name) >= out_size) return SQLITE_CANTOPEN;
+        strcpy(out, name);
+        return SQLITE_OK;
+    }
+    if (strncmp(name, "user://", 7) == 0) {
+        CharString global = ProjectSettings::get_singleton()->globalize_path(String::utf8(name)).utf8();
+        return default_vfs()->xFullPathname(default_vfs(), global.get_data(), out_size, out);
+    }
+    return default_vfs()->xFullPathname(default_vfs(), name, out_size, out);
+}
+
+int SQLite3GodotVFS::register_vfs() {
+    if (godot_vfs_registered) return SQLITE_OK;
+    sqlite3_vfs* fallback = sqlite3_vfs_find(nullptr);
+    if (!fallback) return SQLITE_ERROR;
+
+    // Inherit randomness, sleep, time and dlopen from the default VFS
+    godot_vfs = *fallback;
+    godot_vfs.pNext = nullptr;
+    godot_vfs.zName = NAME;
+    godot_vfs.pAppData = fallback;
+    if (godot_vfs.szOsFile < (int)sizeof(GodotResFile)) godot_vfs.szOsFile = sizeof(GodotResFile);
+    godot_vfs.xOpen = vfs_open;
+    godot_vfs.xDelete = vfs_delete;
+    godot_vfs.xAccess = vfs_access;
+    godot_vfs.xFullPathname = vfs_full_pathname;
+
+    int rc = sqlite3_vfs_register(&godot_vfs, 0);
+    godot_vfs_registered = rc == SQLITE_OK;
+    return rc;
+}
+
+void SQLite3GodotVFS::unregister_vfs() {
+    if (!godot_vfs_registered) return;
+    sqlite3_vfs_unregister(&godot_vfs);
+    godot_vfs_registered = false;
+}
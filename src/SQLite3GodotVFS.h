@@ -0,0 +1,49 @@
+#ifndef _SQLITE3_GODOT_VFS_H
+#define _SQLITE3_GODOT_VFS_H
+
+/**
+ * SQLite3GodotVFS.h
+ *
+ * SQLite VFS that understands Godot paths.
+ *
+ * The "godot" VFS serves res:// databases read-only through FileAccess, so
+ * databases shipped inside the PCK can be opened in place. Every other path
+ * (user://, absolute and relative paths) is globalized and handed to the
+ * platform's default VFS, so journals, WAL and locking work as usual there.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/variant/string.hpp>
+
+#include <sqlite3.h>
+
+using namespace godot;
+
+/**
+ * SQLite3GodotVFS
+ *
+ * Registration of the "godot" VFS (not a Godot class).
+ */
+class SQLite3GodotVFS {
+public:
+    static const char* NAME;
+
+    // Files up to this size are read into memory once when opened, which also
+    // enables zero-copy page access through xFetch (URI parameter "preload")
+    static const int64_t DEFAULT_PRELOAD_LIMIT = 16 * 1024 * 1024;
+
+    // Read cache for larger files: page-aligned blocks, direct-mapped
+    static const int64_t CACHE_BLOCK_SIZE = 64 * 1024;
+    static const int CACHE_BLOCKS = 16;
+
+    static int register_vfs();
+    static void unregister_vfs();
+
+    // True for paths that need this VFS (res:// and user://)
+    static bool is_godot_path(const String& path);
+};
+
+#endif // _SQLITE3_GODOT_VFS_H
@@ -0,0 +1,330 @@
+#include "SQLite3Profiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace sqlite3_gd_prof {
+
+// ---------------------------------------------------------------------------
+// Histogram
+
+static const int SUB_BUCKETS = 1 << Histogram::SUB_BITS;
+static const int HALF_BUCKETS = SUB_BUCKETS / 2;
+
+static int bit_width(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - __builtin_clzll(value) : 0;
+#else
+    int width = 0;
+    while (value) {
+        value >>= 1;
+        width++;
+    }
+    return width;
+#endif
+}
+
+Histogram::Histogram() : _buckets(BUCKETS, 0), _count(0), _min(UINT64_MAX), _max(0) {}
+
+int Histogram::bucket_index(uint64_t value) {
+    if (value < (uint64_t)SUB_BUCKETS) return (int)value;
+    int shift = bit_width(value) - SUB_BITS;
+    if (shift > MAX_SHIFT) return BUCKETS - 1;
+    return shift * HALF_BUCKETS + (int)(value >> shift);
+}
+
+uint64_t Histogram::bucket_lower(int index) {
+    if (index < SUB_BUCKETS) return (uint64_t)index;
+    int shift = index / HALF_BUCKETS - 1;
+    return (uint64_t)(index - shift * HALF_BUCKETS) << shift;
+}
+
+uint64_t Histogram::bucket_upper(int index) {
+    if (index < SUB_BUCKETS) return (uint64_t)index;
+    int shift = index / HALF_BUCKETS - 1;
+    return bucket_lower(index) + ((uint64_t)1 << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    _buckets[bucket_index(value)]++;
+    _count++;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (int i = 0; i < BUCKETS; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+void Histogram::reset() {
+    std::fill(_buckets.begin(), _buckets.end(), 0);
+    _count = 0;
+    _min = UINT64_MAX;
+    _max = 0;
+}
+
+uint64_t Histogram::percentile(double fraction) const {
+    if (_count == 0) return 0;
+    uint64_t target = (uint64_t)std::ceil(std::min(std::max(fraction, 0.0), 1.0) * _count);
+    target = std::max(target, (uint64_t)1);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += _buckets[i];
+        if (seen >= target) {
+            // Highest value of the bucket, but never outside what was recorded
+            return std::max(_min, std::min(bucket_upper(i), _max));
+        }
+    }
+    return _max;
+}
+
+void SqlStats::merge(const SqlStats& other) {
+    calls += other.calls;
+    total_ns += other.total_ns;
+    rows += other.rows;
+    vm_steps += other.vm_steps;
+    latency.merge(other.latency);
+}
+
+// ---------------------------------------------------------------------------
+// SQL normalization
+
+static bool is_identifier_char(char c) {
+    return std::isalnum((unsigned char)c) || c == '_' || c == '$' || (unsigned char)c >= 0x80;
+}
+
+std::string normalize_sql(const char* sql) {
+    std::string out;
+    if (!sql) return out;
+    size_t n = strlen(sql);
+    out.reserve(n);
+    bool space = false;
+    auto emit = [&](char c) {
+        if (space && !out.empty()) out += ' ';
+        space = false;
+        out += c;
+    };
+
+    for (size_t i = 0; i < n;) {
+        char c = sql[i];
+        if (std::isspace((unsigned char)c)) {
+            space = true;
+            i++;
+        } else if (c == '-' && i + 1 < n && sql[i + 1] == '-') {
+            while (i < n && sql[i] != '\n') i++;
+            space = true;
+        } else if (c == '/' && i + 1 < n && sql[i + 1] == '*') {
+            i += 2;
+            while (i + 1 < n && !(sql[i] == '*' && sql[i + 1] == '/')) i++;
+            i = std::min(i + 2, n);
+            space = true;
+        } else if (c == '\'' || ((c == 'x' || c == 'X') && i + 1 < n && sql[i + 1] == '\'' &&
+                                 (i == 0 || !is_identifier_char(sql[i - 1])))) {
+            // String and blob literals, '' is an escaped quote
+            i += c == '\'' ? 1 : 2;
+            while (i < n) {
+                if (sql[i] == '\'') {
+                    if (i + 1 < n && sql[i + 1] == '\'') {
+                        i += 2;
+                        continue;
+                    }
+                    i++;
+                    break;
+                }
+                i++;
+            }
+            emit('?');
+        } else if (c == '?') {
+            // Numbered parameters stay as written
+            emit(c);
+            i++;
+            while (i < n && std::isdigit((unsigned char)sql[i])) out += sql[i++];
+        } else if (c == '"' || c == '`' || c == '[') {
+            // Quoted identifiers are kept as they are
+            char close = c == '[' ? ']' : c;
+            size_t start = i++;
+            while (i < n && sql[i] != close) i++;
+            i = std::min(i + 1, n);
+            emit(sql[start]);
+            out.append(sql + start + 1, i - start - 1);
+        } else if ((std::isdigit((unsigned char)c) || (c == '.' && i + 1 < n && std::isdigit((unsigned char)sql[i + 1]))) &&
+                   (i == 0 || !is_identifier_char(sql[i - 1]))) {
+            // Numeric literals, including hex, decimals and exponents
+            if (c == '0' && i + 1 < n && (sql[i + 1] == 'x' || sql[i + 1] == 'X')) {
+                i += 2;
+                while (i < n && std::isxdigit((unsigned char)sql[i])) i++;
+            } else {
+                while (i < n && (std::isdigit((unsigned char)sql[i]) || sql[i] == '.' || sql[i] == '_')) i++;
+                if (i < n && (sql[i] == 'e' || sql[i] == 'E')) {
+                    i++;
+                    if (i < n && (sql[i] == '+' || sql[i] == '-')) i++;
+                    while (i < n && std::isdigit((unsigned char)sql[i])) i++;
+                }
+            }
+            emit('?');
+        } else {
+            emit(c);
+            i++;
+        }
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Profiler
+
+const char* const Profiler::OVERFLOW_KEY = "(other)";
+
+SqlStats& Profiler::_stats_for(sqlite3_stmt* stmt, const char* sql) {
+    auto it = _keys.find(stmt);
+    if (it != _keys.end() && it->second.sql == sql) return *it->second.stats;
+
+    if (_keys.size() >= MAX_CACHED_STATEMENTS) _keys.clear();
+    std::string key = normalize_sql(sql);
+    auto found = _stats.find(key);
+    if (found == _stats.end()) {
+        if (_stats.size() >= MAX_SQL_TEXTS) key = OVERFLOW_KEY;
+        found = _stats.emplace(std::move(key), SqlStats()).first;
+    }
+    StatementKey& entry = _keys[stmt];
+    entry.sql = sql;
+    entry.stats = &found->second;  // Elements of an unordered_map keep their address
+    return found->second;
+}
+
+void Profiler::on_stmt(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Running& running = _running[stmt];
+    running.rows = 0;
+    running.vm_start = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 0);
+}
+
+void Profiler::on_row(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _running.find(stmt);
+    if (it != _running.end()) it->second.rows++;
+}
+
+void Profiler::on_profile(sqlite3_stmt* stmt, uint64_t elapsed_ns) {
+    const char* sql = sqlite3_sql(stmt);
+    std::lock_guard<std::mutex> lock(_mutex);
+    SqlStats& stats = _stats_for(stmt, sql ? sql : "");
+    stats.calls++;
+    stats.total_ns += elapsed_ns;
+    stats.latency.record(elapsed_ns);
+    auto it = _running.find(stmt);
+    if (it != _running.end()) {
+        // The VM step counter is cumulative over runs of the statement
+        stats.rows += it->second.rows;
+        stats.vm_steps += (uint64_t)std::max(0, sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 0) - it->second.vm_start);
+        _running.erase(it);
+    }
+}
+
+std::unordered_map<std::string, SqlStats> Profiler::snapshot() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.clear();
+    _keys.clear();
+    _running.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Statement events
+
+EventRing::EventRing(uint32_t thread) : _slots(CAPACITY), _head(0), _tail(0), _dropped(0), _thread(thread) {}
+
+void EventRing::push(uint64_t end_usec, uint64_t duration_ns, uint64_t rows, const char* sql) {
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= CAPACITY) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    StatementEvent& event = _slots[head % CAPACITY];
+    event.end_usec = end_usec;
+    event.duration_ns = duration_ns;
+    event.rows = rows;
+    event.thread = _thread;
+    size_t length = sql ? std::min(strlen(sql), (size_t)StatementEvent::SQL_PREVIEW - 1) : 0;
+    memcpy(event.sql, sql, length);
+    event.sql[length] = '\0';
+    _head.store(head + 1, std::memory_order_release);
+}
+
+void EventRing::drain(std::vector<StatementEvent>& out) {
+    uint64_t tail = _tail.load(std::memory_order_relaxed);
+    uint64_t head = _head.load(std::memory_order_acquire);
+    for (; tail < head; ++tail) {
+        out.push_back(_slots[tail % CAPACITY]);
+    }
+    _tail.store(tail, std::memory_order_release);
+}
+
+void EventRing::peek(std::vector<StatementEvent>& out) const {
+    // Slots between tail and head are not overwritten until the tail moves, which only a drain does
+    uint64_t head = _head.load(std::memory_order_acquire);
+    for (uint64_t tail = _tail.load(std::memory_order_relaxed); tail < head; ++tail) {
+        out.push_back(_slots[tail % CAPACITY]);
+    }
+}
+
+uint64_t EventRing::take_dropped() {
+    return _dropped.exchange(0, std::memory_order_relaxed);
+}
+
+static std::atomic<bool> events_on(false);
+
+// Rings outlive their threads, so events of a finished thread are still drained
+static std::mutex rings_mutex;
+static std::vector<std::shared_ptr<EventRing>> rings;
+
+void set_events_enabled(bool enabled) {
+    events_on = enabled;
+}
+
+bool events_enabled() {
+    return events_on.load(std::memory_order_relaxed);
+}
+
+void record_event(uint64_t end_usec, uint64_t duration_ns, uint64_t rows, const char* sql) {
+    thread_local std::shared_ptr<EventRing> ring;
+    if (!ring) {
+        // Only the first event of a thread takes the lock
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        ring = std::make_shared<EventRing>((uint32_t)rings.size());
+        rings.push_back(ring);
+    }
+    ring->push(end_usec, duration_ns, rows, sql);
+}
+
+uint64_t drain_events(std::vector<StatementEvent>& out) {
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    for (const std::shared_ptr<EventRing>& ring : rings) {
+        ring->drain(out);
+        dropped += ring->take_dropped();
+    }
+    return dropped;
+}
+
+void peek_events(std::vector<StatementEvent>& out) {
+    // Under the same lock as drain_events(), so no tail moves while the rings are copied
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    for (const std::shared_ptr<EventRing>& ring : rings) {
+        ring->peek(out);
+    }
+}
+
+} // namespace sqlite3_gd_prof
@@ -0,0 +1,173 @@
+#ifndef _SQLITE3_PROFILER_H
+#define _SQLITE3_PROFILER_H
+
+/**
+ * SQLite3Profiler.h
+ *
+ * Per-SQL statement statistics collected from sqlite3_trace_v2 events.
+ *
+ * SQLite3Database::enable_profiling() forwards the SQLITE_TRACE_STMT, _ROW and
+ * _PROFILE events of its connection to a Profiler, which aggregates them per
+ * SQL text: call count, total time, a latency histogram, rows returned and VM
+ * steps. A statement's SQL is normalized the first time it runs and the result
+ * is cached per statement, so later runs cost two map lookups and a few counter
+ * updates. The number of distinct texts is capped, since each one holds a
+ * histogram of a few kilobytes.
+ *
+ * Latencies go into a log-linear histogram in the style of HdrHistogram: 32
+ * linear buckets below 32 ns, then 16 buckets per power of two, which keeps
+ * every percentile within about 6% of the true value with a fixed amount of
+ * memory.
+ *
+ * For the per-frame debugger view, finished statements are also recorded as
+ * events into one single-producer ring per thread. Recording never takes a
+ * lock; the main thread drains all rings once per frame. This file does not
+ * depend on godot-cpp, so it can be built into native tools and benchmarks as
+ * well.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <sqlite3.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sqlite3_gd_prof {
+
+// Fixed-bucket latency histogram over nanoseconds
+class Histogram {
+public:
+    static const int SUB_BITS = 5;
+    static const int MAX_SHIFT = 40;  // Values above 2^45 ns (about 9.7 hours) are clamped
+    static const int BUCKETS = (MAX_SHIFT + 2) * (1 << (SUB_BITS - 1));
+
+    Histogram();
+
+    void record(uint64_t value);
+    void merge(const Histogram& other);
+    void reset();
+
+    uint64_t count() const { return _count; }
+    uint64_t min() const { return _count ? _min : 0; }
+    uint64_t max() const { return _max; }
+    // Value below which the given fraction (0..1) of the recorded values lie
+    uint64_t percentile(double fraction) const;
+
+    static int bucket_index(uint64_t value);
+    static uint64_t bucket_lower(int index);
+    static uint64_t bucket_upper(int index);
+
+private:
+    std::vector<uint64_t> _buckets;
+    uint64_t _count;
+    uint64_t _min;
+    uint64_t _max;
+};
+
+// Statistics of one SQL text
+struct SqlStats {
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t rows = 0;
+    uint64_t vm_steps = 0;
+    Histogram latency;
+
+    void merge(const SqlStats& other);
+};
+
+// Replaces literals with ? and collapses whitespace, so statements that only
+// differ in their constants are counted together
+std::string normalize_sql(const char* sql);
+
+class Profiler {
+public:
+    static const size_t MAX_SQL_TEXTS = 1000;      // Statements past this are counted under OVERFLOW_KEY
+    static const size_t MAX_CACHED_STATEMENTS = 4096;
+    static const char* const OVERFLOW_KEY;
+
+    // sqlite3_trace_v2 events of one connection
+    void on_stmt(sqlite3_stmt* stmt);
+    void on_row(sqlite3_stmt* stmt);
+    void on_profile(sqlite3_stmt* stmt, uint64_t elapsed_ns);
+
+    // Statistics per normalized SQL text
+    std::unordered_map<std::string, SqlStats> snapshot();
+    void reset();
+
+private:
+    struct Running {
+        uint64_t rows = 0;
+        int vm_start = 0;
+    };
+
+    // Where a statement's runs are counted. The SQL is kept to check the entry, as the address of
+    // a finalized statement is reused by the next one.
+    struct StatementKey {
+        std::string sql;
+        SqlStats* stats = nullptr;
+    };
+
+    SqlStats& _stats_for(sqlite3_stmt* stmt, const char* sql);
+
+    std::mutex _mutex;
+    std::unordered_map<sqlite3_stmt*, Running> _running;
+    std::unordered_map<sqlite3_stmt*, StatementKey> _keys;
+    std::unordered_map<std::string, SqlStats> _stats;  // Keyed by normalized SQL
+};
+
+// One finished statement, as shown in the per-frame debugger view
+struct StatementEvent {
+    static const int SQL_PREVIEW = 120;
+
+    uint64_t end_usec;
+    uint64_t duration_ns;
+    uint64_t rows;
+    uint32_t thread;  // Index of the recording thread's ring
+    char sql[SQL_PREVIEW];  // Truncated, always terminated
+};
+
+// Fixed-size ring written by a single thread and read by another
+class EventRing {
+public:
+    static const uint64_t CAPACITY = 1024;
+
+    explicit EventRing(uint32_t thread);
+
+    // Producer side, drops the event when the ring is full
+    void push(uint64_t end_usec, uint64_t duration_ns, uint64_t rows, const char* sql);
+    // Consumer side, appends everything recorded so far
+    void drain(std::vector<StatementEvent>& out);
+    // Consumer side, appends everything recorded so far and leaves it for the next drain
+    void peek(std::vector<StatementEvent>& out) const;
+    uint64_t take_dropped();
+
+private:
+    std::vector<StatementEvent> _slots;
+    std::atomic<uint64_t> _head;  // Next slot to write
+    std::atomic<uint64_t> _tail;  // Next slot to read
+    std::atomic<uint64_t> _dropped;
+    uint32_t _thread;
+};
+
+// Statement events are recorded only while enabled
+void set_events_enabled(bool enabled);
+bool events_enabled();
+
+// Records into the calling thread's ring
+void record_event(uint64_t end_usec, uint64_t duration_ns, uint64_t rows, const char* sql);
+
+// Moves the events of all threads into out, returns the number dropped since the last call
+uint64_t drain_events(std::vector<StatementEvent>& out);
+// Copies the events of all threads into out, they are still drained afterwards
+void peek_events(std::vector<StatementEvent>& out);
+
+} // namespace sqlite3_gd_prof
+
+#endif // _SQLITE3_PROFILER_H
@@ -1,6 +1,9 @@
 
 
 #include "SQLite3ResultSet.h"
+#include "SQLite3Database.h"
+#include "SQLite3Statement.h"
+#include "SQLite3Workload.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
@@ -11,14 +14,16 @@ SQLite3ResultSet::SQLite3ResultSet() : _stmt(nullptr), _done(true) {}
 
 SQLite3ResultSet::SQLite3ResultSet(sqlite3_stmt* stmt) : _stmt(stmt), _done(false) {}
 
+SQLite3ResultSet::SQLite3ResultSet(const Ref<SQLite3Statement>& statement)
+    : _stmt(statement->get_stmt()), _statement(statement), _done(false) {}
+
 SQLite3ResultSet::~SQLite3ResultSet() {
-    if (_stmt) {
-        sqlite3_finalize(_stmt);
-    }
+    close();
 }
 
 bool SQLite3ResultSet::next() {
     if (!_stmt || _done) return false;
+    SQLite3Database::_resume_statement(_stmt);
     int rc = sqlite3_step(_stmt);
     if (rc == SQLITE_ROW) {
         return true;
@@ -35,46 +40,64 @@ bool SQLite3ResultSet::next() {
 Dictionary SQLite3ResultSet::current_row() {
     Dictionary row;
     if (!_stmt || _done) return row;
-    int cols = sqlite3_column_count(_stmt);
+    const Array& names = _names();
+    int cols = names.size();
     for (int i = 0; i < cols; ++i) {
-        String name = String(sqlite3_column_name(_stmt, i));
-        Variant value;
-        int type = sqlite3_column_type(_stmt, i);
-        switch (type) {
-            case SQLITE_NULL:
-                value = Variant();
-                break;
-            case SQLITE_INTEGER:
-                value = Variant((int64_t)sqlite3_column_int64(_stmt, i));
-                break;
-            case SQLITE_FLOAT:
-                value = Variant(sqlite3_column_double(_stmt, i));
-                break;
-            case SQLITE_TEXT:
-                value = Variant(String((const char*)sqlite3_column_text(_stmt, i)));
-                break;
-            case SQLITE_BLOB: {
-                int size = sqlite3_column_bytes(_stmt, i);
-                PackedByteArray arr;
-                arr.resize(size);
-                memcpy(arr.ptrw(), sqlite3_column_blob(_stmt, i), size);
-                value = Variant(arr);
-                break;
-            }
-        }
-        row[name] = value;
+        row[names[i]] = SQLite3Statement::column_variant(_stmt, i);
     }
     return row;
 }
 
-Array SQLite3ResultSet::column_names() {
-    Array names;
-    if (!_stmt) return names;
-    int cols = sqlite3_column_count(_stmt);
-    for (int i = 0; i < cols; ++i) {
-        names.append(String(sqlite3_column_name(_stmt, i)));
+Dictionary SQLite3ResultSet::fetch_columns(int64_t max_rows) {
+    if (!_stmt || _done) return Dictionary();
+    int rc = SQLITE_DONE;
+    SQLite3Database::_resume_statement(_stmt);
+    Dictionary result = SQLite3Statement::fetch_columns_from(_stmt, max_rows, &rc);
+    if (rc != SQLITE_ROW) _done = true;
+    return result;
+}
+
+const Array& SQLite3ResultSet::_names() {
+    if (_column_names.is_empty() && _stmt) {
+        int cols = sqlite3_column_count(_stmt);
+        _column_names.resize(cols);
+        for (int i = 0; i < cols; ++i) {
+            _column_names[i] = String::utf8(sqlite3_column_name(_stmt, i));
+        }
     }
-    return names;
+    return _column_names;
+}
+
+Array SQLite3ResultSet::column_names() {
+    if (!_stmt) return Array();
+    return _names().duplicate();
+}
+
+Array SQLite3ResultSet::fetch_many(int n) {
+    Array rows;
+    if (!_stmt || _done || n <= 0) return rows;
+    SQLite3Database::_resume_statement(_stmt);
+    int rc = SQLite3Statement::fetch_rows(_stmt, n, rows);
+    if (rc != SQLITE_ROW) _done = true;
+    return rows;
+}
+
+Array SQLite3ResultSet::fetch_all() {
+    Array rows;
+    if (!_stmt || _done) return rows;
+    SQLite3Database::_resume_statement(_stmt);
+    SQLite3Statement::fetch_rows(_stmt, -1, rows);
+    _done = true;
+    return rows;
+}
+
+Dictionary SQLite3ResultSet::fetch_for(int64_t max_usec, int64_t max_rows) {
+    Array rows;
+    if (!_stmt || _done || max_rows == 0) return SQLite3Statement::fetch_result(rows, _done ? SQLITE_DONE : SQLITE_ROW);
+    SQLite3Database::_resume_statement(_stmt);
+    int rc = SQLite3Statement::fetch_rows_for(_stmt, max_usec, max_rows, rows);
+    if (rc != SQLITE_ROW) _done = true;
+    return SQLite3Statement::fetch_result(rows, rc);
 }
 
 int SQLite3ResultSet::column_count() {
@@ -82,10 +105,14 @@ int SQLite3ResultSet::column_count() {
 }
 
 void SQLite3ResultSet::close() {
-    if (_stmt) {
-        sqlite3_finalize(_stmt);
-        _stmt = nullptr;
+    if (_statement.is_valid()) {
+        // Cached statements go back to their cache instead of being destroyed
+        _statement->finalize();
+        _statement.unref();
+    } else if (_stmt) {
+        sqlite3_gd_workload::finalize(_stmt);
     }
+    _stmt = nullptr;
     _done = true;
 }
 
@@ -94,5 +121,9 @@ void SQLite3ResultSet::_bind_methods() {
     ClassDB::bind_method(D_METHOD("current_row"), &SQLite3ResultSet::current_row);
     ClassDB::bind_method(D_METHOD("column_names"), &SQLite3ResultSet::column_names);
     ClassDB::bind_method(D_METHOD("column_count"), &SQLite3ResultSet::column_count);
+    ClassDB::bind_method(D_METHOD("fetch_many", "n"), &SQLite3ResultSet::fetch_many);
+    ClassDB::bind_method(D_METHOD("fetch_all"), &SQLite3ResultSet::fetch_all);
+    ClassDB::bind_method(D_METHOD("fetch_columns", "max_rows"), &SQLite3ResultSet::fetch_columns, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("fetch_for", "max_usec", "max_rows"), &SQLite3ResultSet::fetch_for, DEFVAL(-1));
     ClassDB::bind_method(D_METHOD("close"), &SQLite3ResultSet::close);
 }
\ No newline at end of file
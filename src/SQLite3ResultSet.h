@@ -22,6 +22,8 @@
 
 using namespace godot;
 
+class SQLite3Statement;
+
 /**
  * SQLite3ResultSet
  *
@@ -35,12 +37,17 @@ protected:
 
 private:
     sqlite3_stmt* _stmt;
+    Ref<SQLite3Statement> _statement;  // Set when iterating over a statement owned elsewhere (e.g. cached)
     bool _done;
+    Array _column_names;  // Built once, reused as Dictionary keys for every row
+
+    const Array& _names();
 
 public:
     // Constructors
     SQLite3ResultSet();
     SQLite3ResultSet(sqlite3_stmt* stmt);
+    SQLite3ResultSet(const Ref<SQLite3Statement>& statement);
     virtual ~SQLite3ResultSet();
 
     // Iteration
@@ -49,6 +56,14 @@ public:
     Array column_names();
     int column_count();
 
+    // Bulk fetch (steps natively, one Array per row)
+    Array fetch_many(int n);
+    Array fetch_all();
+    Dictionary fetch_columns(int64_t max_rows = -1);
+
+    // Budgeted fetch, returns {rows, done, rc}
+    Dictionary fetch_for(int64_t max_usec, int64_t max_rows = -1);
+
     // Close
     void close();
 };
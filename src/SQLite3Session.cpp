@@ -0,0 +1,152 @@
+#include "SQLite3Session.h"
+#include "SQLite3Database.h"
+#include "SQLite3Statement.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+SQLite3Session::SQLite3Session() : _session(nullptr) {}
+
+SQLite3Session::SQLite3Session(sqlite3_session* session, const Ref<SQLite3Database>& database)
+    : _session(session), _database(database) {}
+
+SQLite3Session::~SQLite3Session() {
+    close();
+}
+
+int SQLite3Session::attach(const String& zTab) {
+    if (!_session) return SQLITE_MISUSE;
+    // An empty name records every table, including ones created later
+    if (zTab.is_empty()) return sqlite3session_attach(_session, nullptr);
+    return sqlite3session_attach(_session, zTab.utf8().get_data());
+}
+
+int SQLite3Session::diff(const String& zFromDb, const String& zTbl) {
+    if (!_session) return SQLITE_MISUSE;
+    char* errmsg = nullptr;
+    int rc = sqlite3session_diff(_session, zFromDb.utf8().get_data(), zTbl.utf8().get_data(), &errmsg);
+    if (errmsg) {
+        UtilityFunctions::printerr("Session diff error: ", String(errmsg));
+        sqlite3_free(errmsg);
+    }
+    return rc;
+}
+
+// Moves an sqlite3_malloc'd changeset into a PackedByteArray
+static PackedByteArray take_changeset(int rc, int size, void* data, const char* error_prefix) {
+    PackedByteArray bytes;
+    if (rc != SQLITE_OK) {
+        UtilityFunctions::printerr(error_prefix, String(sqlite3_errstr(rc)));
+    } else if (size > 0) {
+        bytes.resize(size);
+        memcpy(bytes.ptrw(), data, size);
+    }
+    sqlite3_free(data);
+    return bytes;
+}
+
+PackedByteArray SQLite3Session::changeset() {
+    if (!_session) return PackedByteArray();
+    int size = 0;
+    void* data = nullptr;
+    int rc = sqlite3session_changeset(_session, &size, &data);
+    return take_changeset(rc, size, data, "Session changeset error: ");
+}
+
+PackedByteArray SQLite3Session::patchset() {
+    if (!_session) return PackedByteArray();
+    int size = 0;
+    void* data = nullptr;
+    int rc = sqlite3session_patchset(_session, &size, &data);
+    return take_changeset(rc, size, data, "Session patchset error: ");
+}
+
+bool SQLite3Session::set_enabled(bool enabled) {
+    return _session ? sqlite3session_enable(_session, enabled ? 1 : 0) != 0 : false;
+}
+
+bool SQLite3Session::is_enabled() {
+    return _session ? sqlite3session_enable(_session, -1) != 0 : false;
+}
+
+bool SQLite3Session::set_indirect(bool indirect) {
+    return _session ? sqlite3session_indirect(_session, indirect ? 1 : 0) != 0 : false;
+}
+
+bool SQLite3Session::is_indirect() {
+    return _session ? sqlite3session_indirect(_session, -1) != 0 : false;
+}
+
+bool SQLite3Session::is_empty() {
+    return _session ? sqlite3session_isempty(_session) != 0 : true;
+}
+
+int64_t SQLite3Session::memory_used() {
+    return _session ? sqlite3session_memory_used(_session) : 0;
+}
+
+int SQLite3Session::close() {
+    if (!_session) return SQLITE_MISUSE;
+    _detach();
+    _database->_remove_session(this);
+    _database.unref();
+    return SQLITE_OK;
+}
+
+void SQLite3Session::_detach() {
+    if (_session) {
+        sqlite3session_delete(_session);
+        _session = nullptr;
+    }
+}
+
+static Array change_values(sqlite3_changeset_iter* iter, int columns,
+                           int (*get)(sqlite3_changeset_iter*, int, sqlite3_value**)) {
+    Array values;
+    values.resize(columns);
+    for (int i = 0; i < columns; ++i) {
+        sqlite3_value* value = nullptr;
+        // Unchanged columns of an UPDATE have no value and stay null
+        if (get(iter, i, &value) == SQLITE_OK && value) {
+            values[i] = SQLite3Statement::value_variant(value);
+        }
+    }
+    return values;
+}
+
+Dictionary SQLite3Session::change_info(sqlite3_changeset_iter* iter, bool with_conflict) {
+    Dictionary info;
+    const char* table = nullptr;
+    int columns = 0;
+    int op = 0;
+    int indirect = 0;
+    if (sqlite3changeset_op(iter, &table, &columns, &op, &indirect) != SQLITE_OK) return info;
+
+    info["table"] = String::utf8(table);
+    info["op"] = op == SQLITE_INSERT ? "INSERT" : (op == SQLITE_UPDATE ? "UPDATE" : "DELETE");
+    info["indirect"] = indirect != 0;
+    info["old"] = op == SQLITE_INSERT ? Array() : change_values(iter, columns, sqlite3changeset_old);
+    info["new"] = op == SQLITE_DELETE ? Array() : change_values(iter, columns, sqlite3changeset_new);
+    if (with_conflict) {
+        info["conflict"] = change_values(iter, columns, sqlite3changeset_conflict);
+    }
+    return info;
+}
+
+void SQLite3Session::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("attach", "zTab"), &SQLite3Session::attach, DEFVAL(String()));
+    ClassDB::bind_method(D_METHOD("diff", "zFromDb", "zTbl"), &SQLite3Session::diff);
+    ClassDB::bind_method(D_METHOD("changeset"), &SQLite3Session::changeset);
+    ClassDB::bind_method(D_METHOD("patchset"), &SQLite3Session::patchset);
+    ClassDB::bind_method(D_METHOD("set_enabled", "enabled"), &SQLite3Session::set_enabled);
+    ClassDB::bind_method(D_METHOD("is_enabled"), &SQLite3Session::is_enabled);
+    ClassDB::bind_method(D_METHOD("set_indirect", "indirect"), &SQLite3Session::set_indirect);
+    ClassDB::bind_method(D_METHOD("is_indirect"), &SQLite3Session::is_indirect);
+    ClassDB::bind_method(D_METHOD("is_empty"), &SQLite3Session::is_empty);
+    ClassDB::bind_method(D_METHOD("memory_used"), &SQLite3Session::memory_used);
+    ClassDB::bind_method(D_METHOD("close"), &SQLite3Session::close);
+}
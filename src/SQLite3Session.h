@@ -0,0 +1,70 @@
+#ifndef _SQLITE3_SESSION_H
+#define _SQLITE3_SESSION_H
+
+/**
+ * SQLite3Session.h
+ *
+ * Godot GDExtension wrapper for SQLite3 session handle.
+ *
+ * This class wraps sqlite3_session* and records the changes made to attached
+ * tables, which can be read back as a changeset or patchset and applied to
+ * another database with SQLite3Database.changeset_apply().
+ *
+ * Original SQLite3 header: <sqlite3.h> (session extension)
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include <sqlite3.h>
+
+using namespace godot;
+
+class SQLite3Database;
+
+/**
+ * SQLite3Session
+ *
+ * Wrapper class for sqlite3_session.
+ */
+class SQLite3Session : public RefCounted {
+    GDCLASS(SQLite3Session, RefCounted);
+
+protected:
+    static void _bind_methods();
+
+private:
+    sqlite3_session* _session;
+    Ref<SQLite3Database> _database;  // Keeps the handle open while the session exists
+
+public:
+    // Constructors
+    SQLite3Session();
+    SQLite3Session(sqlite3_session* session, const Ref<SQLite3Database>& database);
+    virtual ~SQLite3Session();
+
+    // Session operations
+    int attach(const String& zTab = String());
+    int diff(const String& zFromDb, const String& zTbl);
+    PackedByteArray changeset();
+    PackedByteArray patchset();
+    bool set_enabled(bool enabled);
+    bool is_enabled();
+    bool set_indirect(bool indirect);
+    bool is_indirect();
+    bool is_empty();
+    int64_t memory_used();
+    int close();
+
+    // Deletes the native session, the database is about to be closed
+    void _detach();
+
+    // Describes the change under a changeset iterator as
+    // {table, op, indirect, old, new[, conflict]}
+    static Dictionary change_info(sqlite3_changeset_iter* iter, bool with_conflict);
+};
+
+#endif // _SQLITE3_SESSION_H
@@ -0,0 +1,35 @@
+#include "SQLite3Snapshot.h"
+
+#include <godot_cpp/core/class_db.hpp>
+
+using namespace godot;
+
+SQLite3Snapshot::SQLite3Snapshot() : _snapshot(nullptr) {}
+
+SQLite3Snapshot::SQLite3Snapshot(sqlite3_snapshot* snapshot) : _snapshot(snapshot) {}
+
+SQLite3Snapshot::~SQLite3Snapshot() {
+    if (_snapshot) {
+        sqlite3_snapshot_free(_snapshot);
+    }
+}
+
+sqlite3_snapshot* SQLite3Snapshot::get_snapshot() const {
+    return _snapshot;
+}
+
+bool SQLite3Snapshot::is_valid() const {
+    return _snapshot != nullptr;
+}
+
+int SQLite3Snapshot::release() {
+    if (!_snapshot) return SQLITE_MISUSE;
+    sqlite3_snapshot_free(_snapshot);
+    _snapshot = nullptr;
+    return SQLITE_OK;
+}
+
+void SQLite3Snapshot::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("is_valid"), &SQLite3Snapshot::is_valid);
+    ClassDB::bind_method(D_METHOD("release"), &SQLite3Snapshot::release);
+}
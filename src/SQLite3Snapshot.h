@@ -0,0 +1,49 @@
+#ifndef _SQLITE3_SNAPSHOT_H
+#define _SQLITE3_SNAPSHOT_H
+
+/**
+ * SQLite3Snapshot.h
+ *
+ * Godot GDExtension wrapper for SQLite3 snapshot handle.
+ *
+ * This class wraps sqlite3_snapshot*, an identifier of a WAL database state
+ * that other connections can open to read exactly the same data.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/classes/ref_counted.hpp>
+
+#include <sqlite3.h>
+
+using namespace godot;
+
+/**
+ * SQLite3Snapshot
+ *
+ * Wrapper class for sqlite3_snapshot.
+ */
+class SQLite3Snapshot : public RefCounted {
+    GDCLASS(SQLite3Snapshot, RefCounted);
+
+protected:
+    static void _bind_methods();
+
+private:
+    sqlite3_snapshot* _snapshot;
+
+public:
+    // Constructors
+    SQLite3Snapshot();
+    SQLite3Snapshot(sqlite3_snapshot* snapshot);
+    virtual ~SQLite3Snapshot();
+
+    // The snapshot is immutable, so one handle may be opened by several connections at once
+    sqlite3_snapshot* get_snapshot() const;
+    bool is_valid() const;
+    int release();
+};
+
+#endif // _SQLITE3_SNAPSHOT_H
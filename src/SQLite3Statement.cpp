@@ -1,7 +1,19 @@
 #include "SQLite3Statement.h"
+#include "SQLite3ArrayModule.h"
+#include "SQLite3Database.h"
+#include "SQLite3Workload.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <vector>
 
 using namespace godot;
 
@@ -11,7 +23,7 @@ SQLite3Statement::SQLite3Statement(sqlite3_stmt* stmt) : _stmt(stmt) {}
 
 SQLite3Statement::~SQLite3Statement() {
     if (_stmt) {
-        sqlite3_finalize(_stmt);
+        sqlite3_gd_workload::finalize(_stmt);
     }
 }
 
@@ -45,76 +57,213 @@ bool SQLite3Statement::busy() {
     return _stmt ? sqlite3_stmt_busy(_stmt) : false;
 }
 
+int SQLite3Statement::_retain(int index, int rc, const RetainedBuffer& buffer) {
+    // A failed bind leaves the previous value in place, so only track successful ones
+    if (rc == SQLITE_OK) _retained.insert(index, buffer);
+    return rc;
+}
+
+int SQLite3Statement::_release(int index, int rc) {
+    if (rc == SQLITE_OK) _retained.erase(index);
+    return rc;
+}
+
 int SQLite3Statement::bind_blob(int index, const PackedByteArray& value, bool transient) {
     if (!_stmt) return SQLITE_MISUSE;
-    return sqlite3_bind_blob(_stmt, index, value.ptr(), value.size(), transient ? SQLITE_TRANSIENT : SQLITE_STATIC);
+    if (transient) {
+        return _release(index, sqlite3_gd_workload::bind_blob(_stmt, index, value.ptr(), value.size(), SQLITE_TRANSIENT));
+    }
+    // Sharing the array keeps its storage alive and unchanged (writes by the caller copy on write)
+    RetainedBuffer buffer;
+    buffer.bytes = value;
+    return _retain(index, sqlite3_gd_workload::bind_blob(_stmt, index, buffer.bytes.ptr(), buffer.bytes.size(), SQLITE_STATIC), buffer);
 }
 
 int SQLite3Statement::bind_blob64(int index, const PackedByteArray& value, bool transient) {
     if (!_stmt) return SQLITE_MISUSE;
-    return sqlite3_bind_blob64(_stmt, index, value.ptr(), value.size(), transient ? SQLITE_TRANSIENT : SQLITE_STATIC);
+    if (transient) {
+        return _release(index, sqlite3_gd_workload::bind_blob64(_stmt, index, value.ptr(), value.size(), SQLITE_TRANSIENT));
+    }
+    RetainedBuffer buffer;
+    buffer.bytes = value;
+    return _retain(index, sqlite3_gd_workload::bind_blob64(_stmt, index, buffer.bytes.ptr(), buffer.bytes.size(), SQLITE_STATIC), buffer);
 }
 
 int SQLite3Statement::bind_double(int index, double value) {
-    return _stmt ? sqlite3_bind_double(_stmt, index, value) : SQLITE_MISUSE;
+    return _stmt ? _release(index, sqlite3_gd_workload::bind_double(_stmt, index, value)) : SQLITE_MISUSE;
 }
 
 int SQLite3Statement::bind_int(int index, int value) {
-    return _stmt ? sqlite3_bind_int(_stmt, index, value) : SQLITE_MISUSE;
+    return _stmt ? _release(index, sqlite3_gd_workload::bind_int(_stmt, index, value)) : SQLITE_MISUSE;
 }
 
 int SQLite3Statement::bind_int64(int index, int64_t value) {
-    return _stmt ? sqlite3_bind_int64(_stmt, index, value) : SQLITE_MISUSE;
+    return _stmt ? _release(index, sqlite3_gd_workload::bind_int64(_stmt, index, value)) : SQLITE_MISUSE;
 }
 
 int SQLite3Statement::bind_null(int index) {
-    return _stmt ? sqlite3_bind_null(_stmt, index) : SQLITE_MISUSE;
+    return _stmt ? _release(index, sqlite3_gd_workload::bind_null(_stmt, index)) : SQLITE_MISUSE;
 }
 
 int SQLite3Statement::bind_text(int index, const String& value, bool transient) {
     if (!_stmt) return SQLITE_MISUSE;
-    return sqlite3_bind_text(_stmt, index, value.utf8().get_data(), -1, transient ? SQLITE_TRANSIENT : SQLITE_STATIC);
+    RetainedBuffer buffer;
+    buffer.utf8 = value.utf8();
+    if (transient) {
+        return _release(index, sqlite3_gd_workload::bind_text(_stmt, index, buffer.utf8.get_data(), buffer.utf8.length(), SQLITE_TRANSIENT));
+    }
+    return _retain(index, sqlite3_gd_workload::bind_text(_stmt, index, buffer.utf8.get_data(), buffer.utf8.length(), SQLITE_STATIC), buffer);
 }
 
 int SQLite3Statement::bind_text16(int index, const String& value, bool transient) {
     if (!_stmt) return SQLITE_MISUSE;
-    return sqlite3_bind_text16(_stmt, index, value.utf16().ptrw(), -1, transient ? SQLITE_TRANSIENT : SQLITE_STATIC);
+    RetainedBuffer buffer;
+    buffer.utf16 = value.utf16();
+    int bytes = buffer.utf16.length() * (int)sizeof(char16_t);
+    if (transient) {
+        return _release(index, sqlite3_gd_workload::bind_text16(_stmt, index, buffer.utf16.get_data(), bytes, SQLITE_TRANSIENT));
+    }
+    return _retain(index, sqlite3_gd_workload::bind_text16(_stmt, index, buffer.utf16.get_data(), bytes, SQLITE_STATIC), buffer);
 }
 
 int SQLite3Statement::bind_text64(int index, const String& value, bool transient, int encoding) {
     if (!_stmt) return SQLITE_MISUSE;
-    return sqlite3_bind_text64(_stmt, index, value.utf8().get_data(), value.length(), transient ? SQLITE_TRANSIENT : SQLITE_STATIC, encoding);
+    // The length is in bytes of the encoded text, not in characters
+    RetainedBuffer buffer;
+    const char* data;
+    sqlite3_uint64 bytes;
+    if (encoding == SQLITE_UTF16 || encoding == SQLITE_UTF16LE || encoding == SQLITE_UTF16BE) {
+        buffer.utf16 = value.utf16();
+        data = (const char*)buffer.utf16.get_data();
+        bytes = (sqlite3_uint64)buffer.utf16.length() * sizeof(char16_t);
+        encoding = SQLITE_UTF16;  // Godot's UTF-16 is native byte order
+    } else {
+        buffer.utf8 = value.utf8();
+        data = buffer.utf8.get_data();
+        bytes = buffer.utf8.length();
+    }
+    if (transient) {
+        return _release(index, sqlite3_gd_workload::bind_text64(_stmt, index, data, bytes, SQLITE_TRANSIENT, encoding));
+    }
+    return _retain(index, sqlite3_gd_workload::bind_text64(_stmt, index, data, bytes, SQLITE_STATIC, encoding), buffer);
 }
 
 int SQLite3Statement::bind_value(int index, const Variant& value) {
-    // Simplified: convert Variant to appropriate bind
     if (!_stmt) return SQLITE_MISUSE;
+    return _release(index, bind_variant(_stmt, index, value));
+}
+
+// Binds a copy of size bytes, an empty blob rather than NULL when size is 0
+static int bind_raw_blob(sqlite3_stmt* stmt, int index, const void* data, int64_t size) {
+    if (size == 0) {
+        return sqlite3_gd_workload::bind_zeroblob(stmt, index, 0);
+    }
+    return sqlite3_gd_workload::bind_blob64(stmt, index, data, size, SQLITE_TRANSIENT);
+}
+
+int SQLite3Statement::bind_variant(sqlite3_stmt* stmt, int index, const Variant& value) {
     switch (value.get_type()) {
         case Variant::Type::NIL:
-            return bind_null(index);
+            return sqlite3_gd_workload::bind_null(stmt, index);
         case Variant::Type::BOOL:
-            return bind_int(index, value ? 1 : 0);
+            return sqlite3_gd_workload::bind_int(stmt, index, value ? 1 : 0);
         case Variant::Type::INT:
-            return bind_int64(index, value);
+            return sqlite3_gd_workload::bind_int64(stmt, index, (int64_t)value);
         case Variant::Type::FLOAT:
-            return bind_double(index, value);
+            return sqlite3_gd_workload::bind_double(stmt, index, (double)value);
         case Variant::Type::STRING:
-            return bind_text(index, value, true);
-        case Variant::Type::PACKED_BYTE_ARRAY:
-            return bind_blob(index, value, true);
+        case Variant::Type::STRING_NAME:
+        case Variant::Type::NODE_PATH: {
+            CharString utf8 = String(value).utf8();
+            return sqlite3_gd_workload::bind_text(stmt, index, utf8.get_data(), utf8.length(), SQLITE_TRANSIENT);
+        }
+        case Variant::Type::PACKED_BYTE_ARRAY: {
+            PackedByteArray bytes = value;
+            return bind_raw_blob(stmt, index, bytes.ptr(), bytes.size());
+        }
+        // Numeric arrays are stored as their raw native-endian bytes
+        case Variant::Type::PACKED_INT32_ARRAY: {
+            PackedInt32Array array = value;
+            return bind_raw_blob(stmt, index, array.ptr(), array.size() * sizeof(int32_t));
+        }
+        case Variant::Type::PACKED_INT64_ARRAY: {
+            PackedInt64Array array = value;
+            return bind_raw_blob(stmt, index, array.ptr(), array.size() * sizeof(int64_t));
+        }
+        case Variant::Type::PACKED_FLOAT32_ARRAY: {
+            PackedFloat32Array array = value;
+            return bind_raw_blob(stmt, index, array.ptr(), array.size() * sizeof(float));
+        }
+        case Variant::Type::PACKED_FLOAT64_ARRAY: {
+            PackedFloat64Array array = value;
+            return bind_raw_blob(stmt, index, array.ptr(), array.size() * sizeof(double));
+        }
         default:
-            return SQLITE_MISUSE; // Not supported
+            return SQLITE_MISMATCH; // No SQLite storage class for this type
+    }
+}
+
+int SQLite3Statement::bind_all(const Array& values) {
+    if (!_stmt) return SQLITE_MISUSE;
+    for (int i = 0; i < values.size(); ++i) {
+        int rc = _release(i + 1, bind_variant(_stmt, i + 1, values[i]));
+        if (rc != SQLITE_OK) {
+            UtilityFunctions::printerr("Bind error at parameter ", i + 1, ": ", String(sqlite3_errstr(rc)));
+            return rc;
+        }
+    }
+    return SQLITE_OK;
+}
+
+int SQLite3Statement::bind_named(const Dictionary& values) {
+    if (!_stmt) return SQLITE_MISUSE;
+    Array keys = values.keys();
+    for (int i = 0; i < keys.size(); ++i) {
+        const Variant& key = keys[i];
+        int index = key.get_type() == Variant::Type::INT ? (int)key : _named_index(key);
+        int rc = index > 0 ? _release(index, bind_variant(_stmt, index, values[key])) : SQLITE_RANGE;
+        if (rc != SQLITE_OK) {
+            UtilityFunctions::printerr("Bind error at parameter ", key, ": ", String(sqlite3_errstr(rc)));
+            return rc;
+        }
+    }
+    return SQLITE_OK;
+}
+
+int SQLite3Statement::bind_array(int index, const Variant& array) {
+    if (!_stmt) return SQLITE_MISUSE;
+    if (sqlite3_gd_workload::capturing()) {
+        // Pointer bindings cannot be captured, they are replayed as NULL
+        sqlite3_gd_workload::Param param;
+        param.index = index;
+        sqlite3_gd_workload::capture(_stmt, std::move(param));
     }
+    return _release(index, sqlite3_gd_bind_array(_stmt, index, array));
 }
 
+int SQLite3Statement::_named_index(const StringName& name) {
+    const int* cached = _param_index_cache.getptr(name);
+    if (cached) return *cached;
 
+    String text = String(name);
+    int index = sqlite3_bind_parameter_index(_stmt, text.utf8().get_data());
+    if (index == 0 && !text.is_empty() && String(":@$?").find(text.substr(0, 1)) < 0) {
+        // Allow the prefix to be left out, as in {"name": value} for :name
+        static const char* prefixes[] = { ":", "@", "$" };
+        for (int i = 0; index == 0 && i < 3; ++i) {
+            index = sqlite3_bind_parameter_index(_stmt, (String(prefixes[i]) + text).utf8().get_data());
+        }
+    }
+    _param_index_cache.insert(name, index);
+    return index;
+}
 
 int SQLite3Statement::bind_zeroblob(int index, int n) {
-    return _stmt ? sqlite3_bind_zeroblob(_stmt, index, n) : SQLITE_MISUSE;
+    return _stmt ? _release(index, sqlite3_gd_workload::bind_zeroblob(_stmt, index, n)) : SQLITE_MISUSE;
 }
 
 int SQLite3Statement::bind_zeroblob64(int index, int64_t n) {
-    return _stmt ? sqlite3_bind_zeroblob64(_stmt, index, n) : SQLITE_MISUSE;
+    return _stmt ? _release(index, sqlite3_gd_workload::bind_zeroblob64(_stmt, index, n)) : SQLITE_MISUSE;
 }
 
 int SQLite3Statement::bind_parameter_count() {
@@ -130,11 +279,16 @@ int SQLite3Statement::bind_parameter_index(const String& name) {
 }
 
 int SQLite3Statement::clear_bindings() {
-    return _stmt ? sqlite3_clear_bindings(_stmt) : SQLITE_MISUSE;
+    if (!_stmt) return SQLITE_MISUSE;
+    int rc = sqlite3_gd_workload::clear_bindings(_stmt);
+    _retained.clear();
+    return rc;
 }
 
 int SQLite3Statement::step() {
-    return _stmt ? sqlite3_step(_stmt) : SQLITE_MISUSE;
+    if (!_stmt) return SQLITE_MISUSE;
+    SQLite3Database::_resume_statement(_stmt);
+    return sqlite3_step(_stmt);
 }
 
 int SQLite3Statement::data_count() {
@@ -143,9 +297,21 @@ int SQLite3Statement::data_count() {
 
 int SQLite3Statement::finalize() {
     if (!_stmt) return SQLITE_MISUSE;
-    int rc = sqlite3_finalize(_stmt);
+    int rc = SQLITE_OK;
+    if (_cache_owner.is_valid()) {
+        // Statements from a statement cache go back to it, reset so they hold no read transaction
+        rc = sqlite3_reset(_stmt);
+        clear_bindings();
+        SQLite3Database* db = Object::cast_to<SQLite3Database>(ObjectDB::get_instance(_cache_owner));
+        if (db && db->_return_to_cache(Ref<SQLite3Statement>(this), _cache_key)) {
+            return rc;
+        }
+        _cache_owner = ObjectID();
+    }
+    int finalize_rc = sqlite3_gd_workload::finalize(_stmt);
     _stmt = nullptr;
-    return rc;
+    _retained.clear();
+    return rc != SQLITE_OK ? rc : finalize_rc;
 }
 
 int SQLite3Statement::reset() {
@@ -184,22 +350,50 @@ String SQLite3Statement::column_text16(int iCol) {
 
 Variant SQLite3Statement::column_value(int iCol) {
     if (!_stmt) return Variant();
-    sqlite3_value* val = sqlite3_column_value(_stmt, iCol);
-    int type = sqlite3_value_type(val);
-    switch (type) {
-        case SQLITE_NULL:
+    return column_variant(_stmt, iCol);
+}
+
+Variant SQLite3Statement::column_variant(sqlite3_stmt* stmt, int iCol) {
+    switch (sqlite3_column_type(stmt, iCol)) {
+        case SQLITE_INTEGER:
+            return Variant((int64_t)sqlite3_column_int64(stmt, iCol));
+        case SQLITE_FLOAT:
+            return Variant(sqlite3_column_double(stmt, iCol));
+        case SQLITE_TEXT: {
+            const char* text = (const char*)sqlite3_column_text(stmt, iCol);
+            return Variant(String::utf8(text, sqlite3_column_bytes(stmt, iCol)));
+        }
+        case SQLITE_BLOB: {
+            int size = sqlite3_column_bytes(stmt, iCol);
+            PackedByteArray arr;
+            if (size > 0) {
+                arr.resize(size);
+                memcpy(arr.ptrw(), sqlite3_column_blob(stmt, iCol), size);
+            }
+            return Variant(arr);
+        }
+        default:
             return Variant();
+    }
+}
+
+Variant SQLite3Statement::value_variant(sqlite3_value* value) {
+    switch (sqlite3_value_type(value)) {
         case SQLITE_INTEGER:
-            return Variant((int64_t)sqlite3_value_int64(val));
+            return Variant((int64_t)sqlite3_value_int64(value));
         case SQLITE_FLOAT:
-            return Variant(sqlite3_value_double(val));
-        case SQLITE_TEXT:
-            return Variant(String((const char*)sqlite3_value_text(val)));
+            return Variant(sqlite3_value_double(value));
+        case SQLITE_TEXT: {
+            const char* text = (const char*)sqlite3_value_text(value);
+            return Variant(String::utf8(text, sqlite3_value_bytes(value)));
+        }
         case SQLITE_BLOB: {
-            int size = sqlite3_value_bytes(val);
+            int size = sqlite3_value_bytes(value);
             PackedByteArray arr;
-            arr.resize(size);
-            memcpy(arr.ptrw(), sqlite3_value_blob(val), size);
+            if (size > 0) {
+                arr.resize(size);
+                memcpy(arr.ptrw(), sqlite3_value_blob(value), size);
+            }
             return Variant(arr);
         }
         default:
@@ -207,6 +401,321 @@ Variant SQLite3Statement::column_value(int iCol) {
     }
 }
 
+void SQLite3Statement::result_variant(sqlite3_context* ctx, const Variant& value) {
+    switch (value.get_type()) {
+        case Variant::Type::NIL:
+            sqlite3_result_null(ctx);
+            break;
+        case Variant::Type::BOOL:
+            sqlite3_result_int(ctx, value ? 1 : 0);
+            break;
+        case Variant::Type::INT:
+            sqlite3_result_int64(ctx, (int64_t)value);
+            break;
+        case Variant::Type::FLOAT:
+            sqlite3_result_double(ctx, (double)value);
+            break;
+        case Variant::Type::STRING:
+        case Variant::Type::STRING_NAME:
+        case Variant::Type::NODE_PATH: {
+            CharString utf8 = String(value).utf8();
+            sqlite3_result_text(ctx, utf8.get_data(), utf8.length(), SQLITE_TRANSIENT);
+            break;
+        }
+        case Variant::Type::PACKED_BYTE_ARRAY: {
+            PackedByteArray bytes = value;
+            if (bytes.is_empty()) {
+                sqlite3_result_zeroblob(ctx, 0);
+            } else {
+                sqlite3_result_blob64(ctx, bytes.ptr(), bytes.size(), SQLITE_TRANSIENT);
+            }
+            break;
+        }
+        default: {
+            String message = String("Unsupported result type: ") + Variant::get_type_name(value.get_type());
+            CharString utf8 = message.utf8();
+            sqlite3_result_error(ctx, utf8.get_data(), utf8.length());
+            break;
+        }
+    }
+}
+
+Array SQLite3Statement::row_array(sqlite3_stmt* stmt, int cols) {
+    Array row;
+    row.resize(cols);
+    for (int i = 0; i < cols; ++i) {
+        row[i] = column_variant(stmt, i);
+    }
+    return row;
+}
+
+int SQLite3Statement::fetch_rows(sqlite3_stmt* stmt, int64_t max_rows, Array& rows) {
+    int cols = sqlite3_column_count(stmt);
+    int rc = SQLITE_ROW;
+    for (int64_t n = 0; max_rows < 0 || n < max_rows; ++n) {
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_ROW) break;
+        rows.append(row_array(stmt, cols));
+    }
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        UtilityFunctions::printerr("Step error: ", String(sqlite3_errmsg(sqlite3_db_handle(stmt))));
+    }
+    return rc;
+}
+
+int SQLite3Statement::fetch_rows_for(sqlite3_stmt* stmt, int64_t max_usec, int64_t max_rows, Array& rows) {
+    // steady_clock is monotonic and read without a system call on common platforms
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::microseconds(max_usec);
+    int cols = sqlite3_column_count(stmt);
+    int rc = SQLITE_ROW;
+    // At least one row per call, so a slow step still makes progress
+    for (int64_t n = 0; max_rows < 0 || n < max_rows; ++n) {
+        if (n > 0 && Clock::now() >= deadline) break;
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_ROW) break;
+        rows.append(row_array(stmt, cols));
+    }
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        UtilityFunctions::printerr("Step error: ", String(sqlite3_errmsg(sqlite3_db_handle(stmt))));
+    }
+    return rc;
+}
+
+Dictionary SQLite3Statement::fetch_result(const Array& rows, int rc) {
+    Dictionary result;
+    result["rows"] = rows;
+    result["done"] = rc != SQLITE_ROW;
+    result["rc"] = rc == SQLITE_ROW || rc == SQLITE_DONE ? SQLITE_OK : rc;
+    return result;
+}
+
+Dictionary SQLite3Statement::step_for(int64_t max_usec, int64_t max_rows) {
+    Array rows;
+    if (!_stmt || max_rows == 0) return fetch_result(rows, _stmt ? SQLITE_ROW : SQLITE_MISUSE);
+    SQLite3Database::_resume_statement(_stmt);
+    int rc = fetch_rows_for(_stmt, max_usec, max_rows, rows);
+    return fetch_result(rows, rc);
+}
+
+Array SQLite3Statement::fetch_many(int n) {
+    Array rows;
+    if (!_stmt || n <= 0) return rows;
+    SQLite3Database::_resume_statement(_stmt);
+    fetch_rows(_stmt, n, rows);
+    return rows;
+}
+
+Array SQLite3Statement::fetch_all() {
+    Array rows;
+    if (!_stmt) return rows;
+    SQLite3Database::_resume_statement(_stmt);
+    fetch_rows(_stmt, -1, rows);
+    return rows;
+}
+
+// Storage class of one fetch_columns() output column
+enum ColumnKind {
+    COLUMN_UNDECIDED,  // Only NULLs seen so far and no usable declared type
+    COLUMN_INTEGER,    // PackedInt64Array
+    COLUMN_FLOAT,      // PackedFloat64Array
+    COLUMN_TEXT,       // PackedStringArray
+    COLUMN_VARIANT,    // Array (blobs and mixed content), NULLs stay null
+};
+
+// Maps a declared column type to a storage class using SQLite's affinity rules
+static ColumnKind column_kind_from_decltype(const char* decltype_) {
+    if (!decltype_) return COLUMN_UNDECIDED;
+    String type = String::utf8(decltype_).to_upper();
+    if (type.find("INT") >= 0) return COLUMN_INTEGER;
+    if (type.find("CHAR") >= 0 || type.find("CLOB") >= 0 || type.find("TEXT") >= 0) return COLUMN_TEXT;
+    if (type.find("BLOB") >= 0 || type.is_empty()) return COLUMN_VARIANT;
+    if (type.find("REAL") >= 0 || type.find("FLOA") >= 0 || type.find("DOUB") >= 0) return COLUMN_FLOAT;
+    return COLUMN_UNDECIDED;  // NUMERIC affinity, decided by the first value
+}
+
+static ColumnKind column_kind_from_value(int type) {
+    switch (type) {
+        case SQLITE_INTEGER: return COLUMN_INTEGER;
+        case SQLITE_FLOAT: return COLUMN_FLOAT;
+        case SQLITE_TEXT: return COLUMN_TEXT;
+        default: return COLUMN_VARIANT;
+    }
+}
+
+struct ColumnBuffer {
+    ColumnKind kind = COLUMN_UNDECIDED;
+    std::vector<int64_t> ints;
+    std::vector<double> floats;
+    std::vector<String> texts;
+    Array values;
+    std::vector<uint8_t> nulls;
+
+    // Appends a default value for NULLs and for rows seen before the kind was known
+    void push_default() {
+        switch (kind) {
+            case COLUMN_INTEGER: ints.push_back(0); break;
+            case COLUMN_FLOAT: floats.push_back(0.0); break;
+            case COLUMN_TEXT: texts.push_back(String()); break;
+            case COLUMN_VARIANT: values.append(Variant()); break;
+            default: break;
+        }
+    }
+
+    // Moves the values of the previous rows into an Array, once a value does not fit the packed storage class
+    void demote(int64_t rows) {
+        Array demoted;
+        demoted.resize(rows);
+        for (int64_t r = 0; r < rows; ++r) {
+            if (nulls[r]) continue;
+            switch (kind) {
+                case COLUMN_INTEGER: demoted[r] = ints[r]; break;
+                case COLUMN_FLOAT: demoted[r] = floats[r]; break;
+                case COLUMN_TEXT: demoted[r] = texts[r]; break;
+                default: break;
+            }
+        }
+        std::vector<int64_t>().swap(ints);
+        std::vector<double>().swap(floats);
+        std::vector<String>().swap(texts);
+        values = demoted;
+        kind = COLUMN_VARIANT;
+    }
+};
+
+Dictionary SQLite3Statement::fetch_columns_from(sqlite3_stmt* stmt, int64_t max_rows, int* r_rc) {
+    int cols = sqlite3_column_count(stmt);
+    std::vector<ColumnBuffer> buffers(cols);
+    for (int i = 0; i < cols; ++i) {
+        buffers[i].kind = column_kind_from_decltype(sqlite3_column_decltype(stmt, i));
+    }
+
+    int64_t row_count = 0;
+    int rc = SQLITE_ROW;
+    while (max_rows < 0 || row_count < max_rows) {
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_ROW) break;
+        for (int i = 0; i < cols; ++i) {
+            ColumnBuffer& column = buffers[i];
+            int type = sqlite3_column_type(stmt, i);
+            column.nulls.push_back(type == SQLITE_NULL ? 1 : 0);
+            if (column.kind == COLUMN_UNDECIDED) {
+                if (type == SQLITE_NULL) continue;
+                // First value decides, back-fill the leading NULL rows
+                column.kind = column_kind_from_value(type);
+                for (int64_t r = 0; r < row_count; ++r) {
+                    column.push_default();
+                }
+            }
+            if (type == SQLITE_NULL) {
+                column.push_default();
+                continue;
+            }
+            if (column.kind != COLUMN_VARIANT && column.kind != column_kind_from_value(type)) {
+                // Mixed content, keep every value as it is rather than converting it
+                column.demote(row_count);
+            }
+            switch (column.kind) {
+                case COLUMN_INTEGER:
+                    column.ints.push_back(sqlite3_column_int64(stmt, i));
+                    break;
+                case COLUMN_FLOAT:
+                    column.floats.push_back(sqlite3_column_double(stmt, i));
+                    break;
+                case COLUMN_TEXT: {
+                    const char* text = (const char*)sqlite3_column_text(stmt, i);
+                    column.texts.push_back(String::utf8(text, sqlite3_column_bytes(stmt, i)));
+                    break;
+                }
+                default:
+                    column.values.append(column_variant(stmt, i));
+                    break;
+            }
+        }
+        row_count++;
+    }
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        UtilityFunctions::printerr("Step error: ", String(sqlite3_errmsg(sqlite3_db_handle(stmt))));
+    }
+    if (r_rc) *r_rc = rc;
+
+    // Move everything into packed arrays in one go
+    Array names;
+    Array columns;
+    Array nulls;
+    names.resize(cols);
+    columns.resize(cols);
+    nulls.resize(cols);
+    for (int i = 0; i < cols; ++i) {
+        ColumnBuffer& column = buffers[i];
+        names[i] = String::utf8(sqlite3_column_name(stmt, i));
+        switch (column.kind) {
+            case COLUMN_INTEGER: {
+                PackedInt64Array packed;
+                packed.resize(column.ints.size());
+                if (!column.ints.empty()) memcpy(packed.ptrw(), column.ints.data(), column.ints.size() * sizeof(int64_t));
+                columns[i] = packed;
+                break;
+            }
+            case COLUMN_FLOAT: {
+                PackedFloat64Array packed;
+                packed.resize(column.floats.size());
+                if (!column.floats.empty()) memcpy(packed.ptrw(), column.floats.data(), column.floats.size() * sizeof(double));
+                columns[i] = packed;
+                break;
+            }
+            case COLUMN_TEXT: {
+                PackedStringArray packed;
+                packed.resize(column.texts.size());
+                String* dst = packed.ptrw();
+                for (size_t r = 0; r < column.texts.size(); ++r) {
+                    dst[r] = column.texts[r];
+                }
+                columns[i] = packed;
+                break;
+            }
+            case COLUMN_VARIANT:
+                columns[i] = column.values;
+                break;
+            default: {
+                // Only NULLs (or no rows at all)
+                Array values;
+                values.resize(row_count);
+                columns[i] = values;
+                break;
+            }
+        }
+        PackedByteArray mask;
+        mask.resize(column.nulls.size());
+        if (!column.nulls.empty()) memcpy(mask.ptrw(), column.nulls.data(), column.nulls.size());
+        nulls[i] = mask;
+    }
+
+    Dictionary result;
+    result["names"] = names;
+    result["columns"] = columns;
+    result["nulls"] = nulls;
+    result["row_count"] = row_count;
+    return result;
+}
+
+Dictionary SQLite3Statement::fetch_columns(int64_t max_rows) {
+    if (!_stmt) return Dictionary();
+    SQLite3Database::_resume_statement(_stmt);
+    return fetch_columns_from(_stmt, max_rows);
+}
+
+Array SQLite3Statement::column_names() {
+    Array names;
+    if (!_stmt) return names;
+    int cols = sqlite3_column_count(_stmt);
+    names.resize(cols);
+    for (int i = 0; i < cols; ++i) {
+        names[i] = String::utf8(sqlite3_column_name(_stmt, i));
+    }
+    return names;
+}
+
 int SQLite3Statement::column_bytes(int iCol) {
     return _stmt ? sqlite3_column_bytes(_stmt, iCol) : 0;
 }
@@ -288,6 +797,9 @@ void SQLite3Statement::_bind_methods() {
     ClassDB::bind_method(D_METHOD("bind_text16", "index", "value", "transient"), &SQLite3Statement::bind_text16, DEFVAL(true));
     ClassDB::bind_method(D_METHOD("bind_text64", "index", "value", "transient", "encoding"), &SQLite3Statement::bind_text64, DEFVAL(true), DEFVAL(SQLITE_UTF8));
     ClassDB::bind_method(D_METHOD("bind_value", "index", "value"), &SQLite3Statement::bind_value);
+    ClassDB::bind_method(D_METHOD("bind_all", "values"), &SQLite3Statement::bind_all);
+    ClassDB::bind_method(D_METHOD("bind_named", "values"), &SQLite3Statement::bind_named);
+    ClassDB::bind_method(D_METHOD("bind_array", "index", "array"), &SQLite3Statement::bind_array);
 
     ClassDB::bind_method(D_METHOD("bind_zeroblob", "index", "n"), &SQLite3Statement::bind_zeroblob);
     ClassDB::bind_method(D_METHOD("bind_zeroblob64", "index", "n"), &SQLite3Statement::bind_zeroblob64);
@@ -314,6 +826,12 @@ void SQLite3Statement::_bind_methods() {
     ClassDB::bind_method(D_METHOD("column_type", "iCol"), &SQLite3Statement::column_type);
     ClassDB::bind_method(D_METHOD("column_count"), &SQLite3Statement::column_count);
 
+    ClassDB::bind_method(D_METHOD("fetch_many", "n"), &SQLite3Statement::fetch_many);
+    ClassDB::bind_method(D_METHOD("fetch_all"), &SQLite3Statement::fetch_all);
+    ClassDB::bind_method(D_METHOD("column_names"), &SQLite3Statement::column_names);
+    ClassDB::bind_method(D_METHOD("fetch_columns", "max_rows"), &SQLite3Statement::fetch_columns, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("step_for", "max_usec", "max_rows"), &SQLite3Statement::step_for, DEFVAL(-1));
+
     ClassDB::bind_method(D_METHOD("column_name", "N"), &SQLite3Statement::column_name);
     ClassDB::bind_method(D_METHOD("column_name16", "N"), &SQLite3Statement::column_name16);
     ClassDB::bind_method(D_METHOD("column_database_name", "N"), &SQLite3Statement::column_database_name);
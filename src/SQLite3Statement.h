@@ -16,7 +16,11 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/char_string.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
 
 #include <sqlite3.h>
 
@@ -35,6 +39,24 @@ protected:
 
 private:
     sqlite3_stmt* _stmt;
+    ObjectID _cache_owner;  // SQLite3Database whose statement cache finalize() returns the statement to
+    String _cache_key;
+
+    // Buffers bound with SQLITE_STATIC (transient = false), kept alive until the
+    // parameter is rebound, the bindings are cleared or the statement is finalized
+    struct RetainedBuffer {
+        CharString utf8;
+        Char16String utf16;
+        PackedByteArray bytes;
+    };
+    HashMap<int, RetainedBuffer> _retained;
+
+    // Parameter indices looked up by bind_named(), 0 for unknown names
+    HashMap<StringName, int> _param_index_cache;
+
+    int _retain(int index, int rc, const RetainedBuffer& buffer);
+    int _release(int index, int rc);
+    int _named_index(const StringName& name);
 
 public:
     // Constructors
@@ -61,6 +83,9 @@ public:
     int bind_text16(int index, const String& value, bool transient = true);
     int bind_text64(int index, const String& value, bool transient = true, int encoding = SQLITE_UTF8);
     int bind_value(int index, const Variant& value);
+    int bind_all(const Array& values);
+    int bind_named(const Dictionary& values);
+    int bind_array(int index, const Variant& array);  // Argument of gd_array(), not copied
     int bind_zeroblob(int index, int n);
     int bind_zeroblob64(int index, int64_t n);
 
@@ -89,6 +114,15 @@ public:
     int column_type(int iCol);
     int column_count();
 
+    // Bulk fetch (steps natively, one Array per row)
+    Array fetch_many(int n);
+    Array fetch_all();
+    Array column_names();
+    Dictionary fetch_columns(int64_t max_rows = -1);
+
+    // Budgeted fetch, returns {rows, done, rc}
+    Dictionary step_for(int64_t max_usec, int64_t max_rows = -1);
+
     // Column names
     String column_name(int N);
     String column_name16(int N);
@@ -104,9 +138,26 @@ public:
     // Status
     int stmt_status(int op, bool reset = false);
 
+    // Native helpers shared with SQLite3Database batch execution
+    static int bind_variant(sqlite3_stmt* stmt, int index, const Variant& value);
+    static Variant column_variant(sqlite3_stmt* stmt, int iCol);
+    static Array row_array(sqlite3_stmt* stmt, int cols);
+    static int fetch_rows(sqlite3_stmt* stmt, int64_t max_rows, Array& rows);
+    static int fetch_rows_for(sqlite3_stmt* stmt, int64_t max_usec, int64_t max_rows, Array& rows);
+    static Dictionary fetch_result(const Array& rows, int rc);
+    static Dictionary fetch_columns_from(sqlite3_stmt* stmt, int64_t max_rows, int* r_rc = nullptr);
+
+    // Native helpers for user-defined functions and virtual tables
+    static Variant value_variant(sqlite3_value* value);
+    static void result_variant(sqlite3_context* ctx, const Variant& value);
+
     // Internal access
     sqlite3_stmt* get_stmt() const { return _stmt; }
     void set_stmt(sqlite3_stmt* stmt) { _stmt = stmt; }
+    void set_cache_owner(ObjectID owner, const String& sql) {
+        _cache_owner = owner;
+        _cache_key = sql;
+    }
 };
 
 #endif // _SQLITE3_STATEMENT_H
\ No newline at end of file
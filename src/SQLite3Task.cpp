@@ -0,0 +1,288 @@
+#include "SQLite3Task.h"
+#include "SQLite3Database.h"
+#include "SQLite3Statement.h"
+#include "SQLite3Workload.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+// Rows fetched between two cancellation checks of a running query
+static const int64_t QUERY_CHUNK_ROWS = 256;
+
+// Bytes copied from the file between two cancellation checks of a blob import
+static const int64_t BLOB_IMPORT_CHUNK = 256 * 1024;
+
+SQLite3Task::SQLite3Task()
+    : _kind(KIND_EXEC), _task_id(-1), _waited(false), _running(false), _done(false), _cancelled(false) {}
+
+SQLite3Task::~SQLite3Task() {}
+
+void SQLite3Task::start(const Ref<SQLite3Database>& database, Kind kind, const String& sql, const Array& params) {
+    _database = database;
+    _kind = kind;
+    _sql = sql;
+    _params = params.duplicate();
+    _self = Ref<SQLite3Task>(this);
+    _database->_track_task(this, true);
+    _task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &SQLite3Task::_run), false,
+                                                           String("SQLite3Task: ") + _sql.left(64));
+}
+
+void SQLite3Task::_run() {
+    _running = true;
+    sqlite3* db = _database->get_db();
+    if (_cancelled) {
+        _result["rc"] = SQLITE_INTERRUPT;
+        _result["error"] = String("cancelled");
+    } else if (!db) {
+        _result["rc"] = SQLITE_MISUSE;
+        _result["error"] = String("database is closed");
+    } else if (_kind == KIND_QUERY) {
+        _run_query(db);
+    } else if (_kind == KIND_BLOB_IMPORT) {
+        _run_blob_import(db);
+    } else {
+        _run_exec(db);
+    }
+    _running = false;
+    _done = true;
+    _database->_track_task(this, false);
+
+    // Deliver on the main thread
+    callable_mp(this, &SQLite3Task::_finish).call_deferred();
+}
+
+void SQLite3Task::_run_exec(sqlite3* db) {
+    // Statement by statement rather than sqlite3_exec(), so a cancel is checked before each one
+    CharString utf8 = _sql.utf8();
+    const char* tail = utf8.get_data();
+    int rc = SQLITE_OK;
+    while (rc == SQLITE_OK && tail && *tail) {
+        if (_cancelled) {
+            rc = SQLITE_INTERRUPT;
+            break;
+        }
+        sqlite3_stmt* stmt = nullptr;
+        rc = sqlite3_prepare_v2(db, tail, -1, &stmt, &tail);
+        if (rc != SQLITE_OK || !stmt) continue;  // Error, or only whitespace and comments
+        if (_cancelled) {
+            rc = SQLITE_INTERRUPT;
+        } else {
+            do {
+                rc = sqlite3_step(stmt);
+            } while (rc == SQLITE_ROW);
+            if (rc == SQLITE_DONE) rc = SQLITE_OK;
+        }
+        sqlite3_gd_workload::finalize(stmt);
+    }
+    String error = rc == SQLITE_OK ? String() : String::utf8(sqlite3_errmsg(db));
+    _result["rc"] = rc;
+    _result["error"] = error;
+    _result["changes"] = (int64_t)sqlite3_changes64(db);
+    if (rc != SQLITE_OK && !_cancelled) {
+        UtilityFunctions::printerr("SQL exec error: ", error);
+    }
+}
+
+void SQLite3Task::_run_query(sqlite3* db) {
+    Array names;
+    Array rows;
+    sqlite3_stmt* stmt = nullptr;
+    CharString utf8 = _sql.utf8();
+    int rc = sqlite3_prepare_v2(db, utf8.get_data(), utf8.length() + 1, &stmt, nullptr);
+    for (int i = 0; rc == SQLITE_OK && i < _params.size(); ++i) {
+        rc = SQLite3Statement::bind_variant(stmt, i + 1, _params[i]);
+    }
+    if (rc == SQLITE_OK && stmt) {
+        int cols = sqlite3_column_count(stmt);
+        for (int i = 0; i < cols; ++i) {
+            names.append(String::utf8(sqlite3_column_name(stmt, i)));
+        }
+        // Fetch in chunks so a cancel that races the first step is still honoured
+        rc = SQLITE_ROW;
+        while (rc == SQLITE_ROW) {
+            if (_cancelled) {
+                rc = SQLITE_INTERRUPT;
+                break;
+            }
+            rc = SQLite3Statement::fetch_rows(stmt, QUERY_CHUNK_ROWS, rows);
+        }
+        if (rc == SQLITE_DONE) rc = SQLITE_OK;
+    }
+    _result["rc"] = rc;
+    _result["error"] = rc == SQLITE_OK ? String() : String::utf8(sqlite3_errmsg(db));
+    _result["columns"] = names;
+    _result["rows"] = rows;
+    if (rc != SQLITE_OK && !_cancelled) {
+        UtilityFunctions::printerr("Query error: ", String::utf8(sqlite3_errmsg(db)));
+    }
+    sqlite3_gd_workload::finalize(stmt);
+}
+
+static String quote_identifier(const String& name) {
+    return "\"" + name.replace("\"", "\"\"") + "\"";
+}
+
+void SQLite3Task::_run_blob_import(sqlite3* db) {
+    String schema = _params[0];
+    String table = _params[1];
+    String column = _params[2];
+    int64_t row = _params[3];
+    int64_t written = 0;
+    String error;
+    int rc = SQLITE_OK;
+
+    Ref<FileAccess> file = FileAccess::open(_sql, FileAccess::READ);
+    if (file.is_null()) {
+        _result["rc"] = SQLITE_CANTOPEN;
+        _result["error"] = String("cannot open ") + _sql;
+        _result["bytes"] = 0;
+        UtilityFunctions::printerr("Blob import error: cannot open ", _sql);
+        return;
+    }
+    int64_t length = (int64_t)file->get_length();
+
+    // The savepoint spans every chunk. Holding the connection mutex throughout keeps statements
+    // from other threads out of it, they wait for the import instead of being rolled back with it.
+    sqlite3_mutex* mutex = sqlite3_db_mutex(db);
+    sqlite3_mutex_enter(mutex);
+
+    // Size the cell with zeroblob() and fill it in place, so neither side ever
+    // holds more than one chunk of the file
+    bool outermost = sqlite3_get_autocommit(db) != 0;
+    rc = sqlite3_exec(db, "SAVEPOINT gd_blob_import", nullptr, nullptr, nullptr);
+    if (rc != SQLITE_OK) {
+        _result["rc"] = rc;
+        _result["error"] = String::utf8(sqlite3_errmsg(db));
+        _result["bytes"] = 0;
+        UtilityFunctions::printerr("Blob import error: ", String::utf8(sqlite3_errmsg(db)));
+        sqlite3_mutex_leave(mutex);
+        return;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    CharString update = (String("UPDATE ") + quote_identifier(schema) + "." + quote_identifier(table) + " SET " +
+                         quote_identifier(column) + " = zeroblob(?1) WHERE rowid = ?2")
+                            .utf8();
+    rc = sqlite3_prepare_v2(db, update.get_data(), update.length() + 1, &stmt, nullptr);
+    if (rc == SQLITE_OK) rc = sqlite3_gd_workload::bind_int64(stmt, 1, length);
+    if (rc == SQLITE_OK) rc = sqlite3_gd_workload::bind_int64(stmt, 2, row);
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_step(stmt);
+        if (rc == SQLITE_DONE) rc = sqlite3_changes(db) == 1 ? SQLITE_OK : SQLITE_NOTFOUND;
+    }
+    sqlite3_gd_workload::finalize(stmt);
+
+    sqlite3_blob* blob = nullptr;
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_blob_open(db, schema.utf8().get_data(), table.utf8().get_data(), column.utf8().get_data(), row,
+                               1, &blob);
+    }
+    if (rc == SQLITE_OK) {
+        PackedByteArray chunk;
+        chunk.resize(std::min(length, BLOB_IMPORT_CHUNK));
+        while (written < length) {
+            if (_cancelled) {
+                rc = SQLITE_INTERRUPT;
+                break;
+            }
+            int64_t n = std::min(length - written, BLOB_IMPORT_CHUNK);
+            if ((int64_t)file->get_buffer(chunk.ptrw(), n) != n) {
+                rc = SQLITE_IOERR;
+                error = String("short read from ") + _sql;
+                break;
+            }
+            rc = sqlite3_blob_write(blob, chunk.ptr(), (int)n, (int)written);
+            if (rc != SQLITE_OK) break;
+            written += n;
+        }
+    }
+    if (error.is_empty() && rc != SQLITE_OK) {
+        error = rc == SQLITE_NOTFOUND ? String("row not found") : String::utf8(sqlite3_errmsg(db));
+    }
+    sqlite3_blob_close(blob);
+
+    if (rc != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK TO gd_blob_import", nullptr, nullptr, nullptr);
+    }
+    // Outside a transaction the release is the commit, which can still fail
+    int release_rc = sqlite3_exec(db, "RELEASE gd_blob_import", nullptr, nullptr, nullptr);
+    if (release_rc != SQLITE_OK) {
+        if (rc == SQLITE_OK) {
+            rc = release_rc;
+            error = String::utf8(sqlite3_errmsg(db));
+        }
+        // A failed commit leaves the transaction open, it must not outlive the import
+        if (outermost && !sqlite3_get_autocommit(db)) sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+    sqlite3_mutex_leave(mutex);
+
+    _result["rc"] = rc;
+    _result["error"] = error;
+    _result["bytes"] = rc == SQLITE_OK ? written : (int64_t)0;
+    if (rc != SQLITE_OK && !_cancelled) {
+        UtilityFunctions::printerr("Blob import error: ", error);
+    }
+}
+
+void SQLite3Task::_join() {
+    if (_waited || _task_id < 0) return;
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(_task_id);
+    _waited = true;
+}
+
+void SQLite3Task::_finish() {
+    _join();
+    Ref<SQLite3Task> keep = _self;
+    _self.unref();
+    emit_signal("completed", _result);
+}
+
+void SQLite3Task::cancel() {
+    if (_done) return;
+    _cancelled = true;
+    // Stops a statement already stepping. SQLite drops an interrupt issued before
+    // the worker's first step, so the worker also checks _cancelled right before
+    // each statement and each chunk of rows. The result is delivered through
+    // "completed" as usual, this call never waits for the worker.
+    sqlite3* db = _database->get_db();
+    if (_running && db) sqlite3_interrupt(db);
+}
+
+Dictionary SQLite3Task::wait() {
+    _join();
+    return _result;
+}
+
+bool SQLite3Task::is_done() const {
+    return _done;
+}
+
+bool SQLite3Task::is_cancelled() const {
+    return _cancelled;
+}
+
+Dictionary SQLite3Task::get_result() const {
+    return _done ? _result : Dictionary();
+}
+
+String SQLite3Task::get_sql() const {
+    return _sql;
+}
+
+void SQLite3Task::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("cancel"), &SQLite3Task::cancel);
+    ClassDB::bind_method(D_METHOD("wait"), &SQLite3Task::wait);
+    ClassDB::bind_method(D_METHOD("is_done"), &SQLite3Task::is_done);
+    ClassDB::bind_method(D_METHOD("is_cancelled"), &SQLite3Task::is_cancelled);
+    ClassDB::bind_method(D_METHOD("get_result"), &SQLite3Task::get_result);
+    ClassDB::bind_method(D_METHOD("get_sql"), &SQLite3Task::get_sql);
+
+    ADD_SIGNAL(MethodInfo("completed", PropertyInfo(Variant::DICTIONARY, "result")));
+}
@@ -0,0 +1,88 @@
+#ifndef _SQLITE3_TASK_H
+#define _SQLITE3_TASK_H
+
+/**
+ * SQLite3Task.h
+ *
+ * Godot GDExtension handle for SQL work running on the WorkerThreadPool.
+ *
+ * A task is created by SQLite3Database::exec_async()/query_async()/
+ * blob_import_async(). The work runs on a worker thread and the result is
+ * delivered on the main thread through the "completed" signal.
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <sqlite3.h>
+
+#include <atomic>
+
+using namespace godot;
+
+class SQLite3Database;
+
+/**
+ * SQLite3Task
+ *
+ * One asynchronous exec, query or blob import on a database connection.
+ */
+class SQLite3Task : public RefCounted {
+    GDCLASS(SQLite3Task, RefCounted);
+
+protected:
+    static void _bind_methods();
+
+public:
+    enum Kind {
+        KIND_EXEC,
+        KIND_QUERY,
+        KIND_BLOB_IMPORT,  // sql is the source path, params are [schema, table, column, rowid]
+    };
+
+private:
+    Ref<SQLite3Database> _database;
+    Ref<SQLite3Task> _self;  // Keeps the task alive until "completed" was emitted
+    Kind _kind;
+    String _sql;
+    Array _params;
+    Dictionary _result;
+    int64_t _task_id;
+    bool _waited;
+    std::atomic<bool> _running;
+    std::atomic<bool> _done;
+    std::atomic<bool> _cancelled;
+
+    void _run();
+    void _run_exec(sqlite3* db);
+    void _run_query(sqlite3* db);
+    void _run_blob_import(sqlite3* db);
+    void _finish();
+
+public:
+    // Constructors
+    SQLite3Task();
+    virtual ~SQLite3Task();
+
+    // Schedules the work on the WorkerThreadPool (called by SQLite3Database)
+    void start(const Ref<SQLite3Database>& database, Kind kind, const String& sql, const Array& params);
+
+    // Control
+    void cancel();
+    Dictionary wait();
+
+    // Waits for the worker thread, only once (also used by SQLite3Database before closing)
+    void _join();
+
+    // State
+    bool is_done() const;
+    bool is_cancelled() const;
+    Dictionary get_result() const;
+    String get_sql() const;
+};
+
+#endif // _SQLITE3_TASK_H
@@ -0,0 +1,465 @@
+#include "SQLite3VectorFunctions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VEC_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define VEC_TARGET_AVX2
+#define VEC_TARGET_SSE2
+#else
+#define VEC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define VEC_TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VEC_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace sqlite3_gd_vec {
+
+// ---------------------------------------------------------------------------
+// Scalar
+
+float dot_scalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+float l2sq_scalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+void dot_norms_scalar(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b) {
+    float d = 0.0f, na = 0.0f, nb = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        d += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+    *dot = d;
+    *norm_a = na;
+    *norm_b = nb;
+}
+
+// ---------------------------------------------------------------------------
+// x86: SSE2 baseline and AVX2/FMA, selected at runtime
+
+#if defined(VEC_X86)
+
+VEC_TARGET_SSE2 static inline float hsum128(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+VEC_TARGET_SSE2 static float dot_sse(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float sum = hsum128(_mm_add_ps(acc0, acc1));
+    return sum + dot_scalar(a + i, b + i, n - i);
+}
+
+VEC_TARGET_SSE2 static float l2sq_sse(const float* a, const float* b, size_t n) {
+    __m128 acc = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        acc = _mm_add_ps(acc, _mm_mul_ps(d, d));
+    }
+    return hsum128(acc) + l2sq_scalar(a + i, b + i, n - i);
+}
+
+VEC_TARGET_SSE2 static void dot_norms_sse(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b) {
+    __m128 vd = _mm_setzero_ps(), va = _mm_setzero_ps(), vb = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(a + i);
+        __m128 y = _mm_loadu_ps(b + i);
+        vd = _mm_add_ps(vd, _mm_mul_ps(x, y));
+        va = _mm_add_ps(va, _mm_mul_ps(x, x));
+        vb = _mm_add_ps(vb, _mm_mul_ps(y, y));
+    }
+    dot_norms_scalar(a + i, b + i, n - i, dot, norm_a, norm_b);
+    *dot += hsum128(vd);
+    *norm_a += hsum128(va);
+    *norm_b += hsum128(vb);
+}
+
+VEC_TARGET_AVX2 static inline float hsum256(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    __m128 shuf = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+    sum = _mm_add_ps(sum, shuf);
+    shuf = _mm_movehl_ps(shuf, sum);
+    sum = _mm_add_ss(sum, shuf);
+    return _mm_cvtss_f32(sum);
+}
+
+VEC_TARGET_AVX2 static float dot_avx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    return hsum256(_mm256_add_ps(acc0, acc1)) + dot_scalar(a + i, b + i, n - i);
+}
+
+VEC_TARGET_AVX2 static float l2sq_avx2(const float* a, const float* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc = _mm256_fmadd_ps(d, d, acc);
+    }
+    return hsum256(acc) + l2sq_scalar(a + i, b + i, n - i);
+}
+
+VEC_TARGET_AVX2 static void dot_norms_avx2(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b) {
+    __m256 vd = _mm256_setzero_ps(), va = _mm256_setzero_ps(), vb = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(a + i);
+        __m256 y = _mm256_loadu_ps(b + i);
+        vd = _mm256_fmadd_ps(x, y, vd);
+        va = _mm256_fmadd_ps(x, x, va);
+        vb = _mm256_fmadd_ps(y, y, vb);
+    }
+    dot_norms_scalar(a + i, b + i, n - i, dot, norm_a, norm_b);
+    *dot += hsum256(vd);
+    *norm_a += hsum256(va);
+    *norm_b += hsum256(vb);
+}
+
+static bool cpu_has_avx2_fma() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+static bool cpu_has_sse2() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+    return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // VEC_X86
+
+// ---------------------------------------------------------------------------
+// ARM64: NEON is always present
+
+#if defined(VEC_NEON)
+
+static float dot_neon(const float* a, const float* b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + dot_scalar(a + i, b + i, n - i);
+}
+
+static float l2sq_neon(const float* a, const float* b, size_t n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t d = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        acc = vfmaq_f32(acc, d, d);
+    }
+    return vaddvq_f32(acc) + l2sq_scalar(a + i, b + i, n - i);
+}
+
+static void dot_norms_neon(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b) {
+    float32x4_t vd = vdupq_n_f32(0.0f), va = vdupq_n_f32(0.0f), vb = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(a + i);
+        float32x4_t y = vld1q_f32(b + i);
+        vd = vfmaq_f32(vd, x, y);
+        va = vfmaq_f32(va, x, x);
+        vb = vfmaq_f32(vb, y, y);
+    }
+    dot_norms_scalar(a + i, b + i, n - i, dot, norm_a, norm_b);
+    *dot += vaddvq_f32(vd);
+    *norm_a += vaddvq_f32(va);
+    *norm_b += vaddvq_f32(vb);
+}
+
+#endif // VEC_NEON
+
+// ---------------------------------------------------------------------------
+// Dispatch
+
+struct Kernels {
+    float (*dot)(const float*, const float*, size_t);
+    float (*l2sq)(const float*, const float*, size_t);
+    void (*dot_norms)(const float*, const float*, size_t, float*, float*, float*);
+    const char* name;
+};
+
+static Kernels select_kernels() {
+#if defined(VEC_X86)
+    if (cpu_has_avx2_fma()) return { dot_avx2, l2sq_avx2, dot_norms_avx2, "avx2" };
+    if (cpu_has_sse2()) return { dot_sse, l2sq_sse, dot_norms_sse, "sse2" };
+#elif defined(VEC_NEON)
+    return { dot_neon, l2sq_neon, dot_norms_neon, "neon" };
+#endif
+    return { dot_scalar, l2sq_scalar, dot_norms_scalar, "scalar" };
+}
+
+static const Kernels& kernels() {
+    static const Kernels selected = select_kernels();
+    return selected;
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    return kernels().dot(a, b, n);
+}
+
+float l2sq(const float* a, const float* b, size_t n) {
+    return kernels().l2sq(a, b, n);
+}
+
+void dot_norms(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b) {
+    kernels().dot_norms(a, b, n, dot, norm_a, norm_b);
+}
+
+const char* kernel_name() {
+    return kernels().name;
+}
+
+} // namespace sqlite3_gd_vec
+
+// ---------------------------------------------------------------------------
+// SQL functions
+
+using namespace sqlite3_gd_vec;
+
+enum VecMetric {
+    METRIC_COSINE,
+    METRIC_DOT,
+    METRIC_L2,
+};
+
+// A float32 view of a blob argument. Blobs that point into a page buffer are not
+// necessarily 4-byte aligned, those are copied so the kernels can read floats.
+struct VecArg {
+    const float* data = nullptr;
+    size_t size = 0;
+    std::vector<float> copy;
+
+    // Returns SQLITE_OK, SQLITE_NULL for a NULL argument or SQLITE_MISMATCH
+    int load(sqlite3_value* value) {
+        int type = sqlite3_value_type(value);
+        if (type == SQLITE_NULL) return SQLITE_NULL;
+        if (type != SQLITE_BLOB) return SQLITE_MISMATCH;
+        const void* blob = sqlite3_value_blob(value);
+        int bytes = sqlite3_value_bytes(value);
+        if (bytes % sizeof(float) != 0) return SQLITE_MISMATCH;
+        size = bytes / sizeof(float);
+        if (reinterpret_cast<uintptr_t>(blob) % alignof(float) != 0) {
+            copy.resize(size);
+            if (bytes > 0) memcpy(copy.data(), blob, bytes);
+            data = copy.data();
+        } else {
+            data = static_cast<const float*>(blob);
+        }
+        return SQLITE_OK;
+    }
+};
+
+// Loads both vector arguments. Returns false when the result has already been set.
+static bool vec_load_pair(sqlite3_context* ctx, sqlite3_value* va, sqlite3_value* vb, VecArg& a, VecArg& b) {
+    int rc_a = a.load(va);
+    int rc_b = b.load(vb);
+    if (rc_a == SQLITE_NULL || rc_b == SQLITE_NULL) {
+        sqlite3_result_null(ctx);
+        return false;
+    }
+    if (rc_a != SQLITE_OK || rc_b != SQLITE_OK) {
+        sqlite3_result_error(ctx, "vector arguments must be float32 blobs", -1);
+        return false;
+    }
+    if (a.size != b.size) {
+        sqlite3_result_error(ctx, "vector dimensions differ", -1);
+        return false;
+    }
+    return true;
+}
+
+static double vec_cosine_of(const float* a, const float* b, size_t n) {
+    float d, na, nb;
+    dot_norms(a, b, n, &d, &na, &nb);
+    if (na == 0.0f || nb == 0.0f) return 0.0;
+    return (double)d / (std::sqrt((double)na) * std::sqrt((double)nb));
+}
+
+// Higher is better for every metric, so l2 is negated
+static double vec_score(VecMetric metric, const float* a, const float* b, size_t n) {
+    switch (metric) {
+        case METRIC_DOT:
+            return dot(a, b, n);
+        case METRIC_L2:
+            return -std::sqrt((double)l2sq(a, b, n));
+        default:
+            return vec_cosine_of(a, b, n);
+    }
+}
+
+static void vec_dot_func(sqlite3_context* ctx, int, sqlite3_value** argv) {
+    VecArg a, b;
+    if (!vec_load_pair(ctx, argv[0], argv[1], a, b)) return;
+    sqlite3_result_double(ctx, dot(a.data, b.data, a.size));
+}
+
+static void vec_cosine_func(sqlite3_context* ctx, int, sqlite3_value** argv) {
+    VecArg a, b;
+    if (!vec_load_pair(ctx, argv[0], argv[1], a, b)) return;
+    sqlite3_result_double(ctx, vec_cosine_of(a.data, b.data, a.size));
+}
+
+static void vec_l2_func(sqlite3_context* ctx, int, sqlite3_value** argv) {
+    VecArg a, b;
+    if (!vec_load_pair(ctx, argv[0], argv[1], a, b)) return;
+    sqlite3_result_double(ctx, std::sqrt((double)l2sq(a.data, b.data, a.size)));
+}
+
+static void vec_kernel_func(sqlite3_context* ctx, int, sqlite3_value**) {
+    sqlite3_result_text(ctx, kernel_name(), -1, SQLITE_STATIC);
+}
+
+// vec_topk(id, vector, query, k [, metric]) keeps the k best (score, id) pairs in a min-heap
+struct TopK {
+    size_t k = 0;
+    VecMetric metric = METRIC_COSINE;
+    std::vector<float> query;
+    std::vector<std::pair<double, sqlite3_int64>> heap;  // Worst entry on top
+};
+
+static bool topk_worse(const std::pair<double, sqlite3_int64>& a, const std::pair<double, sqlite3_int64>& b) {
+    return a.first > b.first;
+}
+
+static void vec_topk_step(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    TopK** slot = static_cast<TopK**>(sqlite3_aggregate_context(ctx, sizeof(TopK*)));
+    if (!slot) {
+        sqlite3_result_error_nomem(ctx);
+        return;
+    }
+    if (!*slot) {
+        // The query, k and metric are read once per group
+        sqlite3_int64 k = sqlite3_value_int64(argv[3]);
+        VecArg query;
+        if (k <= 0 || query.load(argv[2]) != SQLITE_OK) {
+            sqlite3_result_error(ctx, "vec_topk needs a float32 blob query and k > 0", -1);
+            return;
+        }
+        TopK* state = new TopK();
+        state->k = (size_t)k;
+        state->query.assign(query.data, query.data + query.size);
+        if (argc > 4) {
+            const char* metric = (const char*)sqlite3_value_text(argv[4]);
+            if (metric && sqlite3_stricmp(metric, "dot") == 0) state->metric = METRIC_DOT;
+            else if (metric && sqlite3_stricmp(metric, "l2") == 0) state->metric = METRIC_L2;
+            else if (metric && sqlite3_stricmp(metric, "cosine") != 0) {
+                delete state;
+                sqlite3_result_error(ctx, "vec_topk metric must be 'cosine', 'dot' or 'l2'", -1);
+                return;
+            }
+        }
+        state->heap.reserve(state->k + 1);
+        *slot = state;
+    }
+    TopK* state = *slot;
+
+    VecArg vector;
+    int rc = vector.load(argv[1]);
+    if (rc == SQLITE_NULL) return;  // Rows without a vector are skipped
+    if (rc != SQLITE_OK || vector.size != state->query.size()) {
+        sqlite3_result_error(ctx, "vec_topk vectors must be float32 blobs of the query's dimension", -1);
+        return;
+    }
+    double score = vec_score(state->metric, vector.data, state->query.data(), vector.size);
+    if (state->heap.size() < state->k) {
+        state->heap.emplace_back(score, sqlite3_value_int64(argv[0]));
+        std::push_heap(state->heap.begin(), state->heap.end(), topk_worse);
+    } else if (score > state->heap.front().first) {
+        std::pop_heap(state->heap.begin(), state->heap.end(), topk_worse);
+        state->heap.back() = std::make_pair(score, sqlite3_value_int64(argv[0]));
+        std::push_heap(state->heap.begin(), state->heap.end(), topk_worse);
+    }
+}
+
+static void vec_topk_final(sqlite3_context* ctx) {
+    TopK** slot = static_cast<TopK**>(sqlite3_aggregate_context(ctx, 0));
+    TopK* state = slot ? *slot : nullptr;
+    std::string json = "[";
+    if (state) {
+        // Sorting with the heap's comparator puts the best score first
+        std::sort(state->heap.begin(), state->heap.end(), topk_worse);
+        for (size_t i = 0; i < state->heap.size(); ++i) {
+            if (i > 0) json += ",";
+            json += std::to_string(state->heap[i].second);
+        }
+        delete state;
+    }
+    json += "]";
+    sqlite3_result_text(ctx, json.c_str(), (int)json.size(), SQLITE_TRANSIENT);
+    sqlite3_result_subtype(ctx, 'J');  // Lets json_each() take it without re-parsing as text
+}
+
+int sqlite3_gd_vector_init(sqlite3* db, char**, const sqlite3_api_routines*) {
+    const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS;
+    int rc = sqlite3_create_function_v2(db, "vec_dot", 2, flags, nullptr, vec_dot_func, nullptr, nullptr, nullptr);
+    if (rc == SQLITE_OK) rc = sqlite3_create_function_v2(db, "vec_cosine", 2, flags, nullptr, vec_cosine_func, nullptr, nullptr, nullptr);
+    if (rc == SQLITE_OK) rc = sqlite3_create_function_v2(db, "vec_l2", 2, flags, nullptr, vec_l2_func, nullptr, nullptr, nullptr);
+    if (rc == SQLITE_OK) rc = sqlite3_create_function_v2(db, "vec_kernel", 0, flags, nullptr, vec_kernel_func, nullptr, nullptr, nullptr);
+    for (int n_args = 4; rc == SQLITE_OK && n_args <= 5; ++n_args) {
+        // Declares the 'J' subtype set by vec_topk_final, SQLite 3.45+ may otherwise drop it
+        rc = sqlite3_create_function_v2(db, "vec_topk", n_args, SQLITE_UTF8 | SQLITE_INNOCUOUS | SQLITE_RESULT_SUBTYPE,
+                                        nullptr, nullptr, vec_topk_step, vec_topk_final, nullptr);
+    }
+    return rc;
+}
@@ -0,0 +1,51 @@
+#ifndef _SQLITE3_VECTOR_FUNCTIONS_H
+#define _SQLITE3_VECTOR_FUNCTIONS_H
+
+/**
+ * SQLite3VectorFunctions.h
+ *
+ * Native vector similarity SQL functions over float32 blobs.
+ *
+ * Vectors are stored as blobs of native-endian float32 values, which is what
+ * binding a PackedFloat32Array produces. The functions registered on every
+ * connection are:
+ *
+ *   vec_dot(a, b)                     dot product
+ *   vec_cosine(a, b)                  cosine similarity
+ *   vec_l2(a, b)                      euclidean distance
+ *   vec_topk(id, v, query, k[, m])    aggregate, JSON array of the k best ids
+ *                                     for metric m ('cosine', 'dot' or 'l2')
+ *   vec_kernel()                      name of the SIMD kernel in use
+ *
+ * The kernels use AVX2/FMA or SSE on x86 (picked at runtime), NEON on ARM64
+ * and plain C++ elsewhere. This file does not depend on godot-cpp, so it can
+ * be built into native tools and benchmarks as well.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include <sqlite3.h>
+
+#include <cstddef>
+
+namespace sqlite3_gd_vec {
+
+// Kernels of the best instruction set available on this CPU
+float dot(const float* a, const float* b, size_t n);
+float l2sq(const float* a, const float* b, size_t n);
+void dot_norms(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b);
+const char* kernel_name();
+
+// Portable reference kernels
+float dot_scalar(const float* a, const float* b, size_t n);
+float l2sq_scalar(const float* a, const float* b, size_t n);
+void dot_norms_scalar(const float* a, const float* b, size_t n, float* dot, float* norm_a, float* norm_b);
+
+} // namespace sqlite3_gd_vec
+
+// Registers the vec_* functions on a connection, usable with sqlite3_auto_extension()
+int sqlite3_gd_vector_init(sqlite3* db, char** pzErrMsg, const sqlite3_api_routines* pApi);
+
+#endif // _SQLITE3_VECTOR_FUNCTIONS_H
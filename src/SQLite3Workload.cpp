@@ -0,0 +1,436 @@
+#include "SQLite3Workload.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace sqlite3_gd_workload {
+
+static const size_t FLUSH_BYTES = 64 * 1024;
+
+// The duration SQLite reports with SQLITE_TRACE_PROFILE only has the resolution of the VFS clock,
+// a millisecond on most platforms, so executions are timed here
+static uint64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// ---------------------------------------------------------------------------
+// Encoding
+
+static void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+static void put_signed(std::string& out, int64_t value) {
+    put_varint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void put_bytes(std::string& out, const std::string& bytes) {
+    put_varint(out, bytes.size());
+    out.append(bytes);
+}
+
+static void put_param(std::string& out, const Param& param) {
+    put_varint(out, (uint64_t)param.index);
+    out.push_back((char)param.type);
+    switch (param.type) {
+        case TYPE_INTEGER:
+        case TYPE_ZEROBLOB:
+            put_signed(out, param.integer);
+            break;
+        case TYPE_FLOAT: {
+            uint64_t bits;
+            memcpy(&bits, &param.real, sizeof(bits));
+            for (int i = 0; i < 8; ++i) {
+                out.push_back((char)(bits >> (8 * i)));
+            }
+            break;
+        }
+        case TYPE_TEXT:
+        case TYPE_TEXT16:
+        case TYPE_BLOB:
+            put_bytes(out, param.bytes);
+            break;
+        default:
+            break;
+    }
+}
+
+// Reads from a trace, failing once past the end
+struct Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool ok = true;
+
+    bool at_end() const { return pos >= size; }
+
+    uint8_t byte() {
+        if (pos >= size) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64 && ok; shift += 7) {
+            uint8_t b = byte();
+            value |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t signed_varint() {
+        uint64_t value = varint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    std::string bytes() {
+        uint64_t n = varint();
+        if (!ok || n > size - pos) {
+            ok = false;
+            return std::string();
+        }
+        std::string out(reinterpret_cast<const char*>(data + pos), n);
+        pos += n;
+        return out;
+    }
+
+    Param param() {
+        Param param;
+        param.index = (int)varint();
+        param.type = (ParamType)byte();
+        switch (param.type) {
+            case TYPE_NULL:
+                break;
+            case TYPE_INTEGER:
+            case TYPE_ZEROBLOB:
+                param.integer = signed_varint();
+                break;
+            case TYPE_FLOAT: {
+                uint64_t bits = 0;
+                for (int i = 0; i < 8; ++i) {
+                    bits |= (uint64_t)byte() << (8 * i);
+                }
+                memcpy(&param.real, &bits, sizeof(bits));
+                break;
+            }
+            case TYPE_TEXT:
+            case TYPE_TEXT16:
+            case TYPE_BLOB:
+                param.bytes = bytes();
+                break;
+            default:
+                ok = false;
+        }
+        return param;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Recorder
+
+Recorder::Recorder(Sink sink)
+    : _sink(std::move(sink)), _next_id(1), _last_start_usec(0), _executions(0), _bytes_written(0), _finished(false) {
+    _buffer.append(MAGIC, sizeof(MAGIC));
+}
+
+void Recorder::_flush() {
+    if (_buffer.empty()) return;
+    _sink(reinterpret_cast<const uint8_t*>(_buffer.data()), _buffer.size());
+    _bytes_written += _buffer.size();
+    _buffer.clear();
+}
+
+void Recorder::on_bind(sqlite3_stmt* stmt, Param&& param) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_finished) return;
+    std::vector<Param>& params = _entries[stmt].params;
+    auto it = std::lower_bound(params.begin(), params.end(), param.index,
+                               [](const Param& p, int index) { return p.index < index; });
+    if (it != params.end() && it->index == param.index) {
+        *it = std::move(param);
+    } else {
+        params.insert(it, std::move(param));
+    }
+}
+
+void Recorder::on_clear_bindings(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(stmt);
+    if (it != _entries.end()) it->second.params.clear();
+}
+
+void Recorder::on_finalize(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.erase(stmt);
+}
+
+void Recorder::on_stmt(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_finished) return;
+    Entry& entry = _entries[stmt];
+    // Statements finalized by SQLite itself (exec()) are never forgotten, so a new statement
+    // may reuse their address: a different SQL text makes it a new statement
+    const char* sql = sqlite3_sql(stmt);
+    if (entry.id == 0 || entry.sql != (sql ? sql : "")) {
+        entry.id = _next_id++;
+        entry.sql = sql ? sql : "";
+        _buffer.push_back('S');
+        put_varint(_buffer, entry.id);
+        put_bytes(_buffer, entry.sql);
+    }
+    entry.start_ns = monotonic_ns();
+    entry.rows = 0;
+    entry.running = true;
+}
+
+void Recorder::on_row(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(stmt);
+    if (it != _entries.end() && it->second.running) it->second.rows++;
+}
+
+void Recorder::on_profile(sqlite3_stmt* stmt) {
+    uint64_t end = monotonic_ns();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_finished) return;
+    auto it = _entries.find(stmt);
+    // Statements already running when the capture started are left out
+    if (it == _entries.end() || !it->second.running) return;
+    Entry& entry = it->second;
+    entry.running = false;
+
+    uint64_t start_usec = entry.start_ns / 1000;
+    int64_t delta_usec = _executions == 0 ? 0 : (int64_t)start_usec - (int64_t)_last_start_usec;
+    _last_start_usec = start_usec;
+    _executions++;
+
+    _buffer.push_back('X');
+    put_varint(_buffer, entry.id);
+    put_signed(_buffer, delta_usec);
+    put_varint(_buffer, end - entry.start_ns);
+    put_varint(_buffer, entry.rows);
+    put_varint(_buffer, entry.params.size());
+    for (const Param& param : entry.params) {
+        put_param(_buffer, param);
+    }
+    if (_buffer.size() >= FLUSH_BYTES) _flush();
+}
+
+void Recorder::finish() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_finished) return;
+    _flush();
+    _finished = true;
+    _entries.clear();
+}
+
+uint64_t Recorder::executions() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _executions;
+}
+
+uint64_t Recorder::statements() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _next_id - 1;
+}
+
+uint64_t Recorder::bytes_written() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes_written + _buffer.size();
+}
+
+// ---------------------------------------------------------------------------
+// Connection registry
+
+std::atomic<int> attached_count(0);
+
+static std::mutex registry_mutex;
+static std::unordered_map<sqlite3*, std::shared_ptr<Recorder>> registry;
+
+void attach(sqlite3* db, const std::shared_ptr<Recorder>& recorder) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry[db] = recorder;
+    attached_count = (int)registry.size();
+}
+
+void detach(sqlite3* db) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.erase(db);
+    attached_count = (int)registry.size();
+}
+
+std::shared_ptr<Recorder> recorder_for(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry.find(sqlite3_db_handle(stmt));
+    return it != registry.end() ? it->second : nullptr;
+}
+
+void capture(sqlite3_stmt* stmt, Param&& param) {
+    std::shared_ptr<Recorder> recorder = recorder_for(stmt);
+    if (recorder) recorder->on_bind(stmt, std::move(param));
+}
+
+void capture_bytes(sqlite3_stmt* stmt, int index, ParamType type, const void* data, size_t size) {
+    std::shared_ptr<Recorder> recorder = recorder_for(stmt);
+    if (!recorder) return;
+    Param param;
+    param.index = index;
+    param.type = type;
+    if (data) param.bytes.assign(static_cast<const char*>(data), size);
+    recorder->on_bind(stmt, std::move(param));
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+
+static int bind_param(sqlite3_stmt* stmt, const Param& param) {
+    switch (param.type) {
+        case TYPE_INTEGER:
+            return sqlite3_bind_int64(stmt, param.index, param.integer);
+        case TYPE_FLOAT:
+            return sqlite3_bind_double(stmt, param.index, param.real);
+        case TYPE_TEXT:
+            return sqlite3_bind_text64(stmt, param.index, param.bytes.data(), param.bytes.size(), SQLITE_TRANSIENT,
+                                       SQLITE_UTF8);
+        case TYPE_TEXT16:
+            return sqlite3_bind_text64(stmt, param.index, param.bytes.data(), param.bytes.size(), SQLITE_TRANSIENT,
+                                       SQLITE_UTF16);
+        case TYPE_BLOB:
+            return sqlite3_bind_blob64(stmt, param.index, param.bytes.data(), param.bytes.size(), SQLITE_TRANSIENT);
+        case TYPE_ZEROBLOB:
+            return sqlite3_bind_zeroblob64(stmt, param.index, (sqlite3_uint64)param.integer);
+        default:
+            return sqlite3_bind_null(stmt, param.index);
+    }
+}
+
+ReplayReport replay(sqlite3* db, const uint8_t* data, size_t size, double speed) {
+    ReplayReport report;
+    Reader reader{data, size};
+    if (size < sizeof(MAGIC) || memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        report.rc = SQLITE_NOTADB;
+        report.first_error = "not a workload trace";
+        return report;
+    }
+    reader.pos = sizeof(MAGIC);
+
+    struct Statement {
+        std::string sql;
+        sqlite3_stmt* stmt = nullptr;
+        int prepare_rc = SQLITE_OK;
+    };
+    std::unordered_map<uint64_t, Statement> statements;
+    std::vector<Param> params;
+    auto note_error = [&](const char* what, const std::string& sql) {
+        if (report.first_error.empty()) report.first_error = std::string(what) + " in " + sql;
+    };
+
+    auto wall_start = std::chrono::steady_clock::now();
+    int64_t offset_usec = 0;  // Captured start of the current execution, from the first one
+    while (reader.ok && !reader.at_end()) {
+        uint8_t tag = reader.byte();
+        if (tag == 'S') {
+            uint64_t id = reader.varint();
+            Statement& statement = statements[id];
+            sqlite3_finalize(statement.stmt);
+            statement.stmt = nullptr;
+            statement.sql = reader.bytes();
+            if (!reader.ok) break;
+            statement.prepare_rc = sqlite3_prepare_v3(db, statement.sql.c_str(), (int)statement.sql.size(),
+                                                      SQLITE_PREPARE_PERSISTENT, &statement.stmt, nullptr);
+            if (statement.prepare_rc != SQLITE_OK) note_error(sqlite3_errmsg(db), statement.sql);
+            continue;
+        }
+        if (tag != 'X') {
+            reader.ok = false;
+            break;
+        }
+
+        uint64_t id = reader.varint();
+        offset_usec += reader.signed_varint();
+        uint64_t recorded_ns = reader.varint();
+        uint64_t rows = reader.varint();
+        uint64_t count = reader.varint();
+        params.clear();
+        for (uint64_t i = 0; i < count && reader.ok; ++i) {
+            params.push_back(reader.param());
+        }
+        auto found = statements.find(id);
+        if (!reader.ok || found == statements.end()) {
+            reader.ok = false;
+            break;
+        }
+        Statement& statement = found->second;
+        ReplayStats& stats = report.per_sql[statement.sql];
+
+        if (speed > 0.0) {
+            auto due = wall_start + std::chrono::microseconds((int64_t)(std::max<int64_t>(offset_usec, 0) / speed));
+            std::this_thread::sleep_until(due);
+        }
+
+        int rc = statement.prepare_rc;
+        uint64_t rows_read = 0;
+        uint64_t elapsed_ns = 0;
+        if (statement.stmt) {
+            sqlite3_stmt* stmt = statement.stmt;
+            sqlite3_clear_bindings(stmt);
+            for (const Param& param : params) {
+                bind_param(stmt, param);
+            }
+            // As many rows as were read when captured, plus the step that tells the statement is done
+            auto start = std::chrono::steady_clock::now();
+            rc = SQLITE_ROW;
+            while (rows_read <= rows && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                rows_read++;
+            }
+            elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                             .count();
+            if (rc == SQLITE_ROW) rc = SQLITE_DONE;
+            if (rc != SQLITE_DONE) note_error(sqlite3_errmsg(db), statement.sql);
+            sqlite3_reset(stmt);
+        }
+
+        stats.executions++;
+        stats.rows += rows_read;
+        stats.total_ns += elapsed_ns;
+        stats.recorded.record(recorded_ns);
+        if (rc == SQLITE_DONE) {
+            stats.latency.record(elapsed_ns);
+        } else {
+            stats.errors++;
+        }
+    }
+    report.wall_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_start).count();
+
+    for (auto& entry : statements) {
+        sqlite3_finalize(entry.second.stmt);
+    }
+    for (const auto& entry : report.per_sql) {
+        const ReplayStats& stats = entry.second;
+        report.total.executions += stats.executions;
+        report.total.errors += stats.errors;
+        report.total.rows += stats.rows;
+        report.total.total_ns += stats.total_ns;
+        report.total.latency.merge(stats.latency);
+        report.total.recorded.merge(stats.recorded);
+    }
+    if (!reader.ok) {
+        report.rc = SQLITE_CORRUPT;
+        if (report.first_error.empty()) report.first_error = "truncated or malformed trace";
+    }
+    return report;
+}
+
+} // namespace sqlite3_gd_workload
@@ -0,0 +1,269 @@
+#ifndef _SQLITE3_WORKLOAD_H
+#define _SQLITE3_WORKLOAD_H
+
+/**
+ * SQLite3Workload.h
+ *
+ * Capture and replay of the statements a connection runs.
+ *
+ * While SQLite3Database::start_capture() is active, a Recorder writes one
+ * record per statement execution: which statement, the values bound to it,
+ * how many rows were read, how long it took and when it started relative to
+ * the previous execution. Statement starts, rows and ends come from the
+ * connection's sqlite3_trace_v2 callback, which also sees the statements run
+ * by exec(). SQLite cannot report bound values back, so the bindings made by
+ * this extension go through the bind_* wrappers below, which record the value
+ * before binding it. Values bound with sqlite3_bind_pointer() (bind_array())
+ * are replayed as NULL.
+ *
+ * replay() runs such a trace against another connection, usually a copy of
+ * the captured database with a different schema, index or pragma, and
+ * reports latency distributions per SQL next to the captured ones. Captured
+ * latencies run from the first step to the end or reset of the statement, so
+ * they include the time the caller spent between rows. Statements that call
+ * functions defined by script fail on a connection without them and are
+ * counted as errors.
+ *
+ * Trace format, integers as LEB128 varints ("s" ones zigzag encoded):
+ *
+ *   "GDSQLWL1"
+ *   'S' id sql_bytes sql                        first execution of a statement
+ *   'X' id start_delta_usec(s) duration_ns rows param_count
+ *       { index type value }*                   one execution
+ *
+ * Parameter types are TYPE_*; integers are "s" varints, floats 8 bytes
+ * little-endian, text and blobs a byte count then the bytes, zeroblobs their
+ * size. This file does not depend on godot-cpp, so replay also runs headless
+ * from the native benchmark harness.
+ *
+ * Original SQLite3 header: <sqlite3.h>
+ *
+ * This file is part of SQLite3.gd bindings.
+ */
+
+#include "SQLite3Profiler.h"
+
+#include <sqlite3.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sqlite3_gd_workload {
+
+static const char MAGIC[8] = {'G', 'D', 'S', 'Q', 'L', 'W', 'L', '1'};
+
+enum ParamType {
+    TYPE_NULL = 0,
+    TYPE_INTEGER = 1,
+    TYPE_FLOAT = 2,
+    TYPE_TEXT = 3,
+    TYPE_TEXT16 = 4,
+    TYPE_BLOB = 5,
+    TYPE_ZEROBLOB = 6,
+};
+
+struct Param {
+    int index = 0;
+    ParamType type = TYPE_NULL;
+    int64_t integer = 0;  // Also the size of a zeroblob
+    double real = 0.0;
+    std::string bytes;
+};
+
+class Recorder {
+public:
+    // Receives the encoded trace in chunks, always called with the recorder locked
+    using Sink = std::function<void(const uint8_t* data, size_t size)>;
+
+    explicit Recorder(Sink sink);
+
+    // Bind layer
+    void on_bind(sqlite3_stmt* stmt, Param&& param);
+    void on_clear_bindings(sqlite3_stmt* stmt);
+    void on_finalize(sqlite3_stmt* stmt);
+
+    // sqlite3_trace_v2 events of the captured connection
+    void on_stmt(sqlite3_stmt* stmt);
+    void on_row(sqlite3_stmt* stmt);
+    void on_profile(sqlite3_stmt* stmt);
+
+    // Writes what is buffered and ignores everything recorded afterwards
+    void finish();
+
+    uint64_t executions();
+    uint64_t statements();
+    uint64_t bytes_written();
+
+private:
+    struct Entry {
+        uint64_t id = 0;  // 0 until the statement first runs
+        std::string sql;
+        std::vector<Param> params;  // Sorted by index
+        uint64_t start_ns = 0;
+        uint64_t rows = 0;
+        bool running = false;
+    };
+
+    void _flush();
+
+    std::mutex _mutex;
+    Sink _sink;
+    std::string _buffer;
+    std::unordered_map<sqlite3_stmt*, Entry> _entries;
+    uint64_t _next_id;
+    uint64_t _last_start_usec;
+    uint64_t _executions;
+    uint64_t _bytes_written;
+    bool _finished;
+};
+
+// Recorders by connection, so the bind wrappers find the one of their statement
+void attach(sqlite3* db, const std::shared_ptr<Recorder>& recorder);
+void detach(sqlite3* db);
+std::shared_ptr<Recorder> recorder_for(sqlite3_stmt* stmt);
+
+extern std::atomic<int> attached_count;
+
+// True while any connection is captured, the only cost of the wrappers otherwise
+inline bool capturing() {
+    return attached_count.load(std::memory_order_relaxed) > 0;
+}
+
+void capture(sqlite3_stmt* stmt, Param&& param);
+void capture_bytes(sqlite3_stmt* stmt, int index, ParamType type, const void* data, size_t size);
+
+// sqlite3_bind_* and friends, recording the value while the connection is captured
+inline int bind_null(sqlite3_stmt* stmt, int index) {
+    if (capturing()) {
+        Param param;
+        param.index = index;
+        capture(stmt, std::move(param));
+    }
+    return sqlite3_bind_null(stmt, index);
+}
+
+inline int bind_int64(sqlite3_stmt* stmt, int index, sqlite3_int64 value) {
+    if (capturing()) {
+        Param param;
+        param.index = index;
+        param.type = TYPE_INTEGER;
+        param.integer = value;
+        capture(stmt, std::move(param));
+    }
+    return sqlite3_bind_int64(stmt, index, value);
+}
+
+inline int bind_int(sqlite3_stmt* stmt, int index, int value) {
+    return bind_int64(stmt, index, value);
+}
+
+inline int bind_double(sqlite3_stmt* stmt, int index, double value) {
+    if (capturing()) {
+        Param param;
+        param.index = index;
+        param.type = TYPE_FLOAT;
+        param.real = value;
+        capture(stmt, std::move(param));
+    }
+    return sqlite3_bind_double(stmt, index, value);
+}
+
+inline int bind_text(sqlite3_stmt* stmt, int index, const char* data, int size, void (*destructor)(void*)) {
+    if (capturing()) capture_bytes(stmt, index, TYPE_TEXT, data, size < 0 ? strlen(data) : size);
+    return sqlite3_bind_text(stmt, index, data, size, destructor);
+}
+
+inline int bind_text16(sqlite3_stmt* stmt, int index, const void* data, int size, void (*destructor)(void*)) {
+    if (capturing()) {
+        size_t bytes = size < 0 ? std::char_traits<char16_t>::length((const char16_t*)data) * 2 : size;
+        capture_bytes(stmt, index, TYPE_TEXT16, data, bytes);
+    }
+    return sqlite3_bind_text16(stmt, index, data, size, destructor);
+}
+
+inline int bind_text64(sqlite3_stmt* stmt, int index, const char* data, sqlite3_uint64 size,
+                       void (*destructor)(void*), unsigned char encoding) {
+    if (capturing()) capture_bytes(stmt, index, encoding == SQLITE_UTF8 ? TYPE_TEXT : TYPE_TEXT16, data, size);
+    return sqlite3_bind_text64(stmt, index, data, size, destructor, encoding);
+}
+
+inline int bind_blob64(sqlite3_stmt* stmt, int index, const void* data, sqlite3_uint64 size,
+                       void (*destructor)(void*)) {
+    if (capturing()) capture_bytes(stmt, index, TYPE_BLOB, data, size);
+    return sqlite3_bind_blob64(stmt, index, data, size, destructor);
+}
+
+inline int bind_blob(sqlite3_stmt* stmt, int index, const void* data, int size, void (*destructor)(void*)) {
+    if (capturing()) capture_bytes(stmt, index, TYPE_BLOB, data, size > 0 ? size : 0);
+    return sqlite3_bind_blob(stmt, index, data, size, destructor);
+}
+
+inline int bind_zeroblob(sqlite3_stmt* stmt, int index, int size) {
+    if (capturing()) {
+        Param param;
+        param.index = index;
+        param.type = TYPE_ZEROBLOB;
+        param.integer = size > 0 ? size : 0;
+        capture(stmt, std::move(param));
+    }
+    return sqlite3_bind_zeroblob(stmt, index, size);
+}
+
+inline int bind_zeroblob64(sqlite3_stmt* stmt, int index, sqlite3_uint64 size) {
+    if (capturing()) {
+        Param param;
+        param.index = index;
+        param.type = TYPE_ZEROBLOB;
+        param.integer = (int64_t)size;
+        capture(stmt, std::move(param));
+    }
+    return sqlite3_bind_zeroblob64(stmt, index, size);
+}
+
+inline int clear_bindings(sqlite3_stmt* stmt) {
+    if (capturing()) {
+        std::shared_ptr<Recorder> recorder = recorder_for(stmt);
+        if (recorder) recorder->on_clear_bindings(stmt);
+    }
+    return sqlite3_clear_bindings(stmt);
+}
+
+inline int finalize(sqlite3_stmt* stmt) {
+    if (stmt && capturing()) {
+        std::shared_ptr<Recorder> recorder = recorder_for(stmt);
+        if (recorder) recorder->on_finalize(stmt);
+    }
+    return sqlite3_finalize(stmt);
+}
+
+// Replay statistics of one SQL text
+struct ReplayStats {
+    uint64_t executions = 0;
+    uint64_t errors = 0;
+    uint64_t rows = 0;
+    uint64_t total_ns = 0;
+    sqlite3_gd_prof::Histogram latency;
+    sqlite3_gd_prof::Histogram recorded;  // As captured
+};
+
+struct ReplayReport {
+    int rc = SQLITE_OK;  // SQLITE_NOTADB for something else than a trace, SQLITE_CORRUPT if truncated
+    std::string first_error;
+    uint64_t wall_ns = 0;
+    ReplayStats total;
+    std::unordered_map<std::string, ReplayStats> per_sql;
+};
+
+// speed scales the captured inter-arrival times: 0 runs as fast as possible, 1 at the captured pace
+ReplayReport replay(sqlite3* db, const uint8_t* data, size_t size, double speed = 0.0);
+
+} // namespace sqlite3_gd_workload
+
+#endif // _SQLITE3_WORKLOAD_H
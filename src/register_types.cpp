@@ -10,6 +10,15 @@
 #include "SQLite3ResultSet.h"
 #include "SQLite3Backup.h"
 #include "SQLite3Blob.h"
+#include "SQLite3BlobStream.h"
+#include "SQLite3Task.h"
+#include "SQLite3ConnectionPool.h"
+#include "SQLite3Session.h"
+#include "SQLite3Snapshot.h"
+#include "SQLite3GodotVFS.h"
+#include "SQLite3VectorFunctions.h"
+#include "SQLite3ArrayModule.h"
+#include "SQLite3DebuggerProfiler.h"
 
 using namespace godot;
 
@@ -25,13 +34,34 @@ void gdext_initialize_module(ModuleInitializationLevel p_level) {
     GDREGISTER_CLASS(SQLite3ResultSet);
     GDREGISTER_CLASS(SQLite3Backup);
     GDREGISTER_CLASS(SQLite3Blob);
+    GDREGISTER_CLASS(SQLite3BlobStream);
+    GDREGISTER_CLASS(SQLite3Task);
+    GDREGISTER_CLASS(SQLite3ConnectionPool);
+    GDREGISTER_CLASS(SQLite3Session);
+    GDREGISTER_CLASS(SQLite3Snapshot);
+    GDREGISTER_INTERNAL_CLASS(SQLite3DebuggerProfiler);
+
+    // Lets open()/open_v2() resolve res:// and user:// paths
+    SQLite3GodotVFS::register_vfs();
+
+    // Native vec_* SQL functions on every connection opened from now on
+    sqlite3_auto_extension((void (*)(void))sqlite3_gd_vector_init);
+
+    // gd_array() table-valued function for SQLite3Statement.bind_array()
+    sqlite3_auto_extension((void (*)(void))sqlite3_gd_array_init);
+
+    // "sqlite" profiler for per-frame statement timings in the remote debugger
+    SQLite3DebuggerProfiler::register_profiler();
 }
 
 void gdext_uninitialize_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
-    // Teardown logic (if any) goes here.
+    SQLite3DebuggerProfiler::unregister_profiler();
+    sqlite3_cancel_auto_extension((void (*)(void))sqlite3_gd_array_init);
+    sqlite3_cancel_auto_extension((void (*)(void))sqlite3_gd_vector_init);
+    SQLite3GodotVFS::unregister_vfs();
 }
 
 extern "C" {